@@ -0,0 +1,99 @@
+#include <chrono>
+
+#include <unistd.h>
+
+#include "mapper_private.hpp"
+
+// Emits the .data of a generated weight table, a few MB of .byte, .half and
+// .word arrays with a string here and there, checks every byte against a
+// packer that reads the literals one by one and reports the bandwidth.
+
+#define BENCH_S_LINES  (1u << 17)
+#define BENCH_S_LITS   64
+#define BENCH_S_ROUNDS 5
+
+static const char* BENCH_TYPES[] = { ".byte", ".half", ".word", ".byte", ".half", ".word", ".byte", ".string" };
+
+static void bench_reference(const parser::RISCVAST* ast, uint8_t* bytes) {
+  const lexer::RISCVTokenStream* tokens = ast->tokens;
+  for (uint64_t i = 0; i < ast->s_data; i++) {
+    const parser::RISCVASTN_Data* node = &ast->data[i];
+    const lexer::RISCVTokenType type = lexer::riscv_tokens_get_type(tokens, node->type);
+    const uint64_t s_lit = lexer::riscv_token_get_type_size(type);
+
+    uint64_t s_bytes = 0;
+    for (uint64_t j = 0; j < node->s_lits; j++) {
+      if (type == lexer::TOKEN_STRING) {
+        lexer::riscv_tokens_copy_string(tokens, parser::ast_get_lit(node, j), (char*)bytes + s_bytes);
+        s_bytes += lexer::riscv_tokens_get_string_size(tokens, parser::ast_get_lit(node, j));
+        bytes[s_bytes++] = 0;
+        continue;
+      }
+
+      const uint32_t number = (uint32_t)lexer::riscv_tokens_get_number(tokens, parser::ast_get_lit(node, j));
+      for (uint64_t b = 0; b < s_lit; b++)
+        bytes[s_bytes++] = (uint8_t)(number >> (b << 3));
+    }
+    bytes += riscv_map_data_size((uint32_t)s_bytes);
+  }
+}
+
+int32_t main() {
+  char filename[] = "/tmp/bench_data_XXXXXX";
+  const int fd = mkstemp(filename);
+  error(FATAL, fd < 0, "bench - could not create temporary source file ", filename, __FILE__, __LINE__);
+
+  FILE* file = fdopen(fd, "w");
+  fprintf(file, ".data\n");
+  for (uint32_t i = 0; i < BENCH_S_LINES; i++) {
+    const char* type = BENCH_TYPES[i % (sizeof(BENCH_TYPES) / sizeof(BENCH_TYPES[0]))];
+    fprintf(file, "weights_%u: %s ", i, type);
+    for (uint32_t j = 0; j < BENCH_S_LITS; j++) {
+      if (type[1] == 's')
+        fprintf(file, "%s\"layer %u%srow %u\"", j ? ", " : "", i, j & 1 ? "\\t" : " ", j); // every other one has an escape
+      else {
+        // signed values that fit the directive, so the sign bits get packed too
+        const uint32_t bits = type[1] == 'b' ? 8 : (type[1] == 'h' ? 16 : 32);
+        const int32_t number = (int32_t)((i * 2654435761u + j * 40503u) << (32 - bits)) >> (32 - bits);
+        fprintf(file, "%s%d", j ? ", " : "", number);
+      }
+    }
+    fprintf(file, "\n");
+  }
+  fclose(file);
+
+  lexer::RISCVStrTab* strtab = lexer::riscv_strtab_create();
+  lexer::RISCVTokenStream* tokens = lexer::lex(filename, strtab);
+  parser::RISCVAST* ast = parser::parse(tokens);
+  error(FATAL, ast->error, "bench - generated weight table does not parse", "", __FILE__, __LINE__);
+
+  const uint32_t s_data = mapper::map_data_size(ast);
+  uint32_t* data = (uint32_t*)calloc(s_data, sizeof(uint32_t));
+  uint32_t* reference = (uint32_t*)calloc(s_data, sizeof(uint32_t));
+  error(FATAL, data == nullptr || reference == nullptr, "bench - allocation of data images returned a nullptr", "", __FILE__, __LINE__);
+  bench_reference(ast, (uint8_t*)reference);
+
+  double best = 0;
+  for (uint32_t r = 0; r < BENCH_S_ROUNDS; r++) {
+    memset(data, 0, s_data * sizeof(uint32_t));
+
+    const auto start = std::chrono::steady_clock::now();
+    mapper::map_data2bin(ast, data);
+    const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    best = r == 0 || t < best ? t : best;
+    error(FATAL, memcmp(data, reference, s_data * sizeof(uint32_t)) != 0, "bench - map_data2bin disagrees with the reference packer", "", __FILE__, __LINE__);
+  }
+
+  const double s_mb = (double)s_data * sizeof(uint32_t) / (1 << 20);
+  printf("emitting %.1f MB of data from %u directives\n", s_mb, BENCH_S_LINES);
+  printf("  map_data2bin %6.3f s  (%.0f MB/s)\n", best, s_mb / best);
+
+  free(reference);
+  free(data);
+  parser::ast_free(ast);
+  lexer::riscv_tokens_free(tokens);
+  lexer::riscv_strtab_free(strtab);
+  unlink(filename);
+  return 0;
+}
@@ -0,0 +1,69 @@
+#include <chrono>
+
+#include "lexer_private.hpp"
+
+// Compares the perfect hash keyword lookup against the strcmp cascade it
+// replaced, on a token mix dominated by label and data symbol names.
+
+#define BENCH_S_TOKENS  (1 << 20)
+#define BENCH_S_ROUNDS  8
+#define BENCH_MAX_TOKEN (1 << 5)
+
+lexer::RISCVTokenType bench_keyword_cascade(const char* token) {
+  for (uint32_t i = 0; i < LEXER_S_KEYWORDS; i++)
+    if (strcmp(token, LEXER_KEYWORDS[i].name) == 0)
+      return LEXER_KEYWORDS[i].type;
+  return lexer::TOKEN_SYMBOL;
+}
+
+int32_t main() {
+  char (*tokens)[BENCH_MAX_TOKEN] = (char(*)[BENCH_MAX_TOKEN])malloc(BENCH_S_TOKENS * BENCH_MAX_TOKEN);
+  uint32_t* s_tokens = (uint32_t*)malloc(BENCH_S_TOKENS * sizeof(uint32_t));
+  error(FATAL, tokens == nullptr || s_tokens == nullptr, "bench - allocation of token set returned a nullptr", "", __FILE__, __LINE__);
+
+  uint32_t seed = 0x2545F491;
+  for (uint32_t i = 0; i < BENCH_S_TOKENS; i++) {
+    seed = seed * 1664525 + 1013904223;
+    switch (seed >> 29) {
+      case 0: case 1: {
+        strcpy(tokens[i], LEXER_KEYWORDS[(seed >> 8) % LEXER_S_KEYWORDS].name);
+        break;
+      }
+      case 2: case 3: case 4: {
+        snprintf(tokens[i], BENCH_MAX_TOKEN, "val_%u_%u", (seed >> 8) & 0xF, (seed >> 12) & 0x7);
+        break;
+      }
+      default: {
+        snprintf(tokens[i], BENCH_MAX_TOKEN, "lns_kernel_loop_%u", (seed >> 8) & 0xFFF);
+        break;
+      }
+    }
+    s_tokens[i] = (uint32_t)strlen(tokens[i]);
+  }
+
+  uint64_t checksum_cascade = 0, checksum_hash = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t r = 0; r < BENCH_S_ROUNDS; r++)
+    for (uint32_t i = 0; i < BENCH_S_TOKENS; i++)
+      checksum_cascade += bench_keyword_cascade(tokens[i]);
+  const double t_cascade = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  for (uint32_t r = 0; r < BENCH_S_ROUNDS; r++)
+    for (uint32_t i = 0; i < BENCH_S_TOKENS; i++)
+      checksum_hash += _lexer_keyword_lookup(tokens[i], s_tokens[i]);
+  const double t_hash = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  error(FATAL, checksum_cascade != checksum_hash, "bench - keyword lookups disagree", "", __FILE__, __LINE__);
+
+  const double n = (double)BENCH_S_TOKENS * BENCH_S_ROUNDS;
+  printf("keyword lookup (%u tokens x %u rounds)\n", BENCH_S_TOKENS, BENCH_S_ROUNDS);
+  printf("  strcmp cascade: %8.2f ns/token\n", t_cascade * 1e9 / n);
+  printf("  perfect hash:   %8.2f ns/token\n", t_hash * 1e9 / n);
+  printf("  speedup:        %8.2fx\n", t_cascade / t_hash);
+
+  free(s_tokens);
+  free(tokens);
+  return 0;
+}
@@ -0,0 +1,77 @@
+#include <chrono>
+#include <thread>
+
+#include "lexer_private.hpp"
+
+// Lexes a generated multi-million line source with lex and with lex_parallel
+// on a growing number of threads, checks that every run produces the same
+// stream and reports the speedup over lex.
+
+#define BENCH_S_LINES  (1u << 22)
+#define BENCH_S_ROUNDS 3
+
+static const char* BENCH_LINES[] = {
+  "lns_kernel_loop_%u:\n",
+  "    lhu     t0, 0(s0)            # weight\n",
+  "    lhu     t1, 0(s1)            # activation\n",
+  "    ladd    t2, t0, t1\n",
+  "    addi    s0, s0, %u\n",
+  "    bne     s0, s2, lns_kernel_loop_%u\n",
+  "    la      a0, msg_%u\n",
+};
+
+static uint64_t bench_checksum(const lexer::RISCVTokenStream* tokens) {
+  uint64_t checksum = tokens->s_lines;
+  for (uint64_t i = 0; i < tokens->s_tokens; i++) {
+    checksum = checksum * 31 + ((uint64_t)tokens->types[i] << 32 | tokens->offsets[i]);
+    checksum = checksum * 31 + tokens->lits[i].id;
+  }
+  return checksum;
+}
+
+static double bench_lex(const char* filename, const uint32_t s_threads, uint64_t& checksum) {
+  double best = 0;
+  for (uint32_t r = 0; r < BENCH_S_ROUNDS; r++) {
+    lexer::RISCVStrTab* strtab = lexer::riscv_strtab_create();
+
+    const auto start = std::chrono::steady_clock::now();
+    lexer::RISCVTokenStream* tokens = s_threads == 0
+      ? lexer::lex(filename, strtab)
+      : lexer::lex_parallel(filename, strtab, s_threads);
+    const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    best = r == 0 || t < best ? t : best;
+    checksum = bench_checksum(tokens);
+    lexer::riscv_tokens_free(tokens);
+    lexer::riscv_strtab_free(strtab);
+  }
+  return best;
+}
+
+int32_t main() {
+  char filename[] = "/tmp/bench_lex_parallel_XXXXXX";
+  const int fd = mkstemp(filename);
+  error(FATAL, fd < 0, "bench - could not create temporary source file ", filename, __FILE__, __LINE__);
+
+  FILE* file = fdopen(fd, "w");
+  for (uint32_t i = 0; i < BENCH_S_LINES; i++) {
+    const uint32_t k = i / (sizeof(BENCH_LINES) / sizeof(BENCH_LINES[0]));
+    fprintf(file, BENCH_LINES[i % (sizeof(BENCH_LINES) / sizeof(BENCH_LINES[0]))], k % 4096);
+  }
+  fclose(file);
+
+  uint64_t reference = 0;
+  const double t_lex = bench_lex(filename, 0, reference);
+  printf("lexing %u lines on %u hardware threads\n", BENCH_S_LINES, std::thread::hardware_concurrency());
+  printf("  lex            %6.3f s\n", t_lex);
+
+  for (uint32_t s_threads = 1; s_threads <= 16; s_threads <<= 1) {
+    uint64_t checksum = 0;
+    const double t = bench_lex(filename, s_threads, checksum);
+    error(FATAL, checksum != reference, "bench - lex_parallel disagrees with lex on threads: ", s_threads, __FILE__, __LINE__);
+    printf("  lex_parallel %2u %6.3f s  (%.2fx)\n", s_threads, t, t_lex / t);
+  }
+
+  unlink(filename);
+  return 0;
+}
@@ -0,0 +1,91 @@
+#include <chrono>
+#include <thread>
+
+#include <unistd.h>
+
+#include "mapper_private.hpp"
+
+// Encodes the lowered .text of a generated multi-million line kernel on a
+// growing number of threads, checks that every run produces the same words
+// as one thread and reports the speedup over it.
+
+#define BENCH_S_LINES  (1u << 22)
+#define BENCH_S_ROUNDS 3
+
+static const char* BENCH_LINES[] = {
+  "lns_kernel_loop_%u:\n",
+  "    lhu     t0, 0(s0)            # weight\n",
+  "    lhu     t1, 0(s1)            # activation\n",
+  "    ladd    t2, t0, t1\n",
+  "    addi    s0, s0, 4\n",
+  "    bne     s0, s2, lns_kernel_loop_%u\n",
+  "    la      a0, lns_kernel_loop_%u\n",
+};
+
+static uint64_t bench_checksum(const uint32_t* insts, const uint32_t s_insts) {
+  uint64_t checksum = s_insts;
+  for (uint32_t i = 0; i < s_insts; i++)
+    checksum = checksum * 31 + insts[i];
+  return checksum;
+}
+
+static double bench_map(const parser::RISCVIR* ir, const uint8_t* sizes, uint32_t* insts, const uint32_t s_insts, const uint32_t s_threads, uint64_t& checksum) {
+  double best = 0;
+  for (uint32_t r = 0; r < BENCH_S_ROUNDS; r++) {
+    memset(insts, 0, s_insts * sizeof(uint32_t));
+
+    const auto start = std::chrono::steady_clock::now();
+    mapper::map_inst2bin(ir, sizes, insts, 0x80000000, 0x80000000 + s_insts * sizeof(uint32_t), s_threads);
+    const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    best = r == 0 || t < best ? t : best;
+    checksum = bench_checksum(insts, s_insts);
+  }
+  return best;
+}
+
+int32_t main() {
+  char filename[] = "/tmp/bench_map_parallel_XXXXXX";
+  const int fd = mkstemp(filename);
+  error(FATAL, fd < 0, "bench - could not create temporary source file ", filename, __FILE__, __LINE__);
+
+  FILE* file = fdopen(fd, "w");
+  fprintf(file, ".text\n");
+  for (uint32_t i = 0; i < BENCH_S_LINES; i++) {
+    const uint32_t k = i / (sizeof(BENCH_LINES) / sizeof(BENCH_LINES[0]));
+    fprintf(file, BENCH_LINES[i % (sizeof(BENCH_LINES) / sizeof(BENCH_LINES[0]))], k);
+  }
+  fclose(file);
+
+  lexer::RISCVStrTab* strtab = lexer::riscv_strtab_create();
+  lexer::RISCVTokenStream* tokens = lexer::lex(filename, strtab);
+  parser::RISCVAST* ast = parser::parse(tokens);
+  error(FATAL, ast->error, "bench - generated kernel does not parse", "", __FILE__, __LINE__);
+  parser::RISCVIR* ir = parser::lower(ast);
+  parser::ast_free(ast);
+  lexer::riscv_tokens_free(tokens);
+  lexer::riscv_strtab_free(strtab);
+
+  uint8_t* sizes = (uint8_t*)malloc(ir->s_insts);
+  const uint32_t s_insts = mapper::map_text_size(ir, sizes);
+  uint32_t* insts = (uint32_t*)malloc(s_insts * sizeof(uint32_t));
+  error(FATAL, sizes == nullptr || insts == nullptr, "bench - allocation of encoding buffers returned a nullptr", "", __FILE__, __LINE__);
+
+  uint64_t reference = 0;
+  const double t_map = bench_map(ir, sizes, insts, s_insts, 1, reference);
+  printf("encoding %u words on %u hardware threads\n", s_insts, std::thread::hardware_concurrency());
+  printf("  map_inst2bin  1 %6.3f s\n", t_map);
+
+  for (uint32_t s_threads = 2; s_threads <= 16; s_threads <<= 1) {
+    uint64_t checksum = 0;
+    const double t = bench_map(ir, sizes, insts, s_insts, s_threads, checksum);
+    error(FATAL, checksum != reference, "bench - parallel encoding disagrees with one thread on threads: ", s_threads, __FILE__, __LINE__);
+    printf("  map_inst2bin %2u %6.3f s  (%.2fx)\n", s_threads, t, t_map / t);
+  }
+
+  free(insts);
+  free(sizes);
+  parser::ir_free(ir);
+  unlink(filename);
+  return 0;
+}
@@ -0,0 +1,91 @@
+#include <chrono>
+#include <random>
+
+#include "lexer_private.hpp"
+
+// Converts a table of random decimal, hexa and binary literals with the old
+// digit at a time loop and with the SWAR parser, checks both agree with
+// strtoull (and on overflow) and reports the time per literal.
+
+#define BENCH_S_LITS   (1 << 16)
+#define BENCH_S_ROUNDS 32
+#define BENCH_S_LIT    40
+
+typedef struct bench_lit {
+  char     str[BENCH_S_LIT];
+  uint32_t s_str;
+  uint32_t radix;
+} BenchLit;
+
+static bool bench_parse_loop(const char* digits, const uint32_t s_digits, const uint32_t radix, uint64_t& n) {
+  n = 0;
+  for (uint32_t i = 0; i < s_digits; i++) {
+    const char ch = digits[i];
+    const uint64_t d =
+      (_lexer_ch_is_digit(ch)) * (uint64_t)(ch - '0') +
+      (_lexer_ch_is_upper_hexa(ch)) * ((uint64_t)(ch - 'A') + 10) +
+      (_lexer_ch_is_lower_hexa(ch)) * ((uint64_t)(ch - 'a') + 10);
+    n = n * radix + d;
+    if (n > UINT32_MAX)
+      return false;
+  }
+  return true;
+}
+
+int32_t main() {
+  static BenchLit lits[BENCH_S_LITS];
+  std::mt19937_64 rng(42);
+
+  const uint32_t radixes[] = { 10, 16, 2 };
+  for (uint32_t i = 0; i < BENCH_S_LITS; i++) {
+    const uint32_t radix = radixes[i % 3];
+    // mostly 32 bit values, every 16th is wider so overflow is exercised too
+    const uint64_t value = rng() >> (i % 16 == 0 ? 20 : 32 + rng() % 32);
+
+    char* str = lits[i].str;
+    if (radix == 10) {
+      lits[i].s_str = (uint32_t)snprintf(str, BENCH_S_LIT, "%llu", (unsigned long long)value);
+    } else if (radix == 16) {
+      lits[i].s_str = (uint32_t)snprintf(str, BENCH_S_LIT, "%llX", (unsigned long long)value);
+    } else {
+      uint32_t s_str = 0;
+      for (int32_t b = 63 - __builtin_clzll(value | 1); b >= 0; b--)
+        str[s_str++] = (char)('0' + ((value >> b) & 1));
+      str[s_str] = '\0';
+      lits[i].s_str = s_str;
+    }
+    lits[i].radix = radix;
+
+    uint64_t n;
+    const bool fits = _lexer_parse_digits(str, lits[i].s_str, radix, n);
+    error(FATAL, fits != (value <= UINT32_MAX), "bench - overflow detection is wrong for literal ", str, __FILE__, __LINE__);
+    error(FATAL, fits && n != strtoull(str, nullptr, (int)radix), "bench - SWAR parser disagrees with strtoull on ", str, __FILE__, __LINE__);
+  }
+
+  uint64_t checksum_loop = 0, checksum_swar = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t r = 0; r < BENCH_S_ROUNDS; r++) {
+    for (uint32_t i = 0; i < BENCH_S_LITS; i++) {
+      uint64_t n;
+      checksum_loop += bench_parse_loop(lits[i].str, lits[i].s_str, lits[i].radix, n) ? n : 1;
+    }
+  }
+  const double t_loop = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  for (uint32_t r = 0; r < BENCH_S_ROUNDS; r++) {
+    for (uint32_t i = 0; i < BENCH_S_LITS; i++) {
+      uint64_t n;
+      checksum_swar += _lexer_parse_digits(lits[i].str, lits[i].s_str, lits[i].radix, n) ? n : 1;
+    }
+  }
+  const double t_swar = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+  error(FATAL, checksum_loop != checksum_swar, "bench - digit loop and SWAR parser disagree", "", __FILE__, __LINE__);
+
+  printf("number literals (%u literals x %u rounds)\n", BENCH_S_LITS, BENCH_S_ROUNDS);
+  printf("  digit loop: %8.2f ns/literal\n", t_loop / (BENCH_S_LITS * BENCH_S_ROUNDS));
+  printf("  SWAR:       %8.2f ns/literal (%.2fx)\n", t_swar / (BENCH_S_LITS * BENCH_S_ROUNDS), t_loop / t_swar);
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include <chrono>
+#include <thread>
+
+#include <unistd.h>
+
+#include "parser_private.hpp"
+
+// Parses the .text of a generated multi-million line kernel with parse and
+// with parse_parallel on a growing number of threads, checks that every run
+// produces the same nodes and reports the speedup over parse.
+
+#define BENCH_S_LINES  (1u << 22)
+#define BENCH_S_ROUNDS 3
+
+static const char* BENCH_LINES[] = {
+  "lns_kernel_loop_%u:\n",
+  "    lhu     t0, 0(s0)            # weight\n",
+  "    lhu     t1, 0(s1)            # activation\n",
+  "    ladd    t2, t0, t1\n",
+  "    addi    s0, s0, %u\n",
+  "    bne     s0, s2, lns_kernel_loop_%u\n",
+  "    la      a0, msg_%u\n",
+};
+
+static uint64_t bench_checksum(const parser::RISCVAST* ast) {
+  uint64_t checksum = ast->s_text;
+  for (uint64_t i = 0; i < ast->s_text; i++) {
+    const parser::RISCVASTN_Text* node = parser::ast_get_text(ast, i);
+    checksum = checksum * 31 + ((uint64_t)node->inst << 24 | (uint64_t)node->fields << 8 | node->form);
+  }
+  return checksum;
+}
+
+static double bench_parse(const lexer::RISCVTokenStream* tokens, const uint32_t s_threads, uint64_t& checksum) {
+  double best = 0;
+  for (uint32_t r = 0; r < BENCH_S_ROUNDS; r++) {
+    const auto start = std::chrono::steady_clock::now();
+    parser::RISCVAST* ast = s_threads == 0
+      ? parser::parse(tokens)
+      : parser::parse_parallel(tokens, s_threads);
+    const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    best = r == 0 || t < best ? t : best;
+    checksum = bench_checksum(ast);
+    parser::ast_free(ast);
+  }
+  return best;
+}
+
+int32_t main() {
+  char filename[] = "/tmp/bench_parse_parallel_XXXXXX";
+  const int fd = mkstemp(filename);
+  error(FATAL, fd < 0, "bench - could not create temporary source file ", filename, __FILE__, __LINE__);
+
+  FILE* file = fdopen(fd, "w");
+  fprintf(file, ".text\n");
+  for (uint32_t i = 0; i < BENCH_S_LINES; i++) {
+    const uint32_t k = i / (sizeof(BENCH_LINES) / sizeof(BENCH_LINES[0]));
+    fprintf(file, BENCH_LINES[i % (sizeof(BENCH_LINES) / sizeof(BENCH_LINES[0]))], k % 4096);
+  }
+  fclose(file);
+
+  lexer::RISCVStrTab* strtab = lexer::riscv_strtab_create();
+  lexer::RISCVTokenStream* tokens = lexer::lex(filename, strtab);
+
+  uint64_t reference = 0;
+  const double t_parse = bench_parse(tokens, 0, reference);
+  printf("parsing %u lines on %u hardware threads\n", BENCH_S_LINES, std::thread::hardware_concurrency());
+  printf("  parse            %6.3f s\n", t_parse);
+
+  for (uint32_t s_threads = 1; s_threads <= 16; s_threads <<= 1) {
+    uint64_t checksum = 0;
+    const double t = bench_parse(tokens, s_threads, checksum);
+    error(FATAL, checksum != reference, "bench - parse_parallel disagrees with parse on threads: ", s_threads, __FILE__, __LINE__);
+    printf("  parse_parallel %2u %6.3f s  (%.2fx)\n", s_threads, t, t_parse / t);
+  }
+
+  lexer::riscv_tokens_free(tokens);
+  lexer::riscv_strtab_free(strtab);
+  unlink(filename);
+  return 0;
+}
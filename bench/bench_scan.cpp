@@ -0,0 +1,87 @@
+#include <chrono>
+
+#include "lexer_private.hpp"
+
+// Runs the byte skipping kernels of every available scanner over a heavily
+// indented and commented source, checks they agree and reports throughput.
+
+#define BENCH_S_SRC    (1 << 26)
+#define BENCH_S_ROUNDS 4
+
+static const char* BENCH_LINES[] = {
+  "    # load the next pair of LNS operands from the weight table\n",
+  "    lhu     t0, 0(s0)            # weight\n",
+  "    lhu     t1, 0(s1)            # activation\n",
+  "\n",
+  "        ladd    t2, t0, t1       # accumulate in the log domain\n",
+  "lns_kernel_loop_17:\n",
+  "    addi    s0, s0, 2\n",
+  "\t\t# ------------------------------------------------------------\n",
+};
+
+uint64_t bench_scan(const LexerScanner& scanner, const char* src) {
+  uint64_t checksum = 0;
+  for (const char* str = src; *str != CHAR_END;) {
+    str = scanner.find_not_space(str);
+    if (*str == CHAR_HASH) {
+      str = scanner.find_line_end(str);
+    } else if (LEXER_CH_CLASS.classes[(uint8_t)*str] & CH_CLASS_IDENT) {
+      str = scanner.find_ident_end(str);
+    } else if (*str != CHAR_END) {
+      str++;
+    }
+    checksum = checksum * 31 + (uint64_t)(str - src);
+  }
+  return checksum;
+}
+
+int32_t main() {
+  char* src = (char*)malloc(BENCH_S_SRC + 1);
+  error(FATAL, src == nullptr, "bench - allocation of source buffer returned a nullptr", "", __FILE__, __LINE__);
+
+  uint64_t s_src = 0;
+  for (uint32_t i = 0;; i++) {
+    const char* line = BENCH_LINES[i % (sizeof(BENCH_LINES) / sizeof(BENCH_LINES[0]))];
+    const uint64_t s_line = strlen(line);
+    if (s_src + s_line > BENCH_S_SRC)
+      break;
+    memcpy(src + s_src, line, s_line);
+    s_src += s_line;
+  }
+  src[s_src] = CHAR_END;
+
+  const LexerScanner* scanners[] = { &LEXER_SCANNER_SCALAR, &LEXER_SCANNER_SSE2, &LEXER_SCANNER_AVX2 };
+  const LexerScanner& selected = _lexer_scanner();
+
+  printf("byte skipping (%lu MiB x %u rounds, runtime selection: %s)\n", s_src >> 20, BENCH_S_ROUNDS, selected.name);
+
+  uint64_t reference = 0;
+  double t_scalar = 0;
+  for (const LexerScanner* scanner : scanners) {
+    uint64_t checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t r = 0; r < BENCH_S_ROUNDS; r++)
+      checksum = bench_scan(*scanner, src);
+    const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (scanner == &LEXER_SCANNER_SCALAR) {
+      reference = checksum;
+      t_scalar  = t;
+    }
+    error(FATAL, checksum != reference, "bench - scanner disagrees with the scalar scanner: ", scanner->name, __FILE__, __LINE__);
+
+    printf(
+      "  %-7s %8.2f GiB/s  (%.2fx)\n",
+      scanner->name,
+      (double)s_src * BENCH_S_ROUNDS / t / (1 << 30),
+      t_scalar / t
+    );
+
+    // scanners are listed narrowest first, anything past the selected one is unsupported
+    if (scanner->find_line_end == selected.find_line_end)
+      break;
+  }
+
+  free(src);
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include <chrono>
+
+#include <sys/resource.h>
+
+#include "lexer_private.hpp"
+
+// Lexes a large generated source twice, first batch by batch through the
+// streaming lexer and then all at once through lex, and reports the peak RSS
+// after each. The streaming pass runs first since the peak only ever grows.
+
+#define BENCH_S_SRC   (1ull << 27)
+#define BENCH_S_BATCH (1 << 12)
+
+static const char* BENCH_LINES[] = {
+  "lns_kernel_loop:\n",
+  "    lhu     t0, 0(s0)            # weight\n",
+  "    lhu     t1, 0(s1)            # activation\n",
+  "    ladd    t2, t0, t1\n",
+  "    addi    s0, s0, 2\n",
+  "    bne     s0, s2, lns_kernel_loop\n",
+};
+
+static uint64_t bench_checksum(const lexer::RISCVTokenStream* tokens, uint64_t checksum) {
+  for (uint64_t i = 0; i < tokens->s_tokens; i++)
+    checksum = checksum * 31 + ((uint64_t)tokens->types[i] << 32 | tokens->offsets[i]);
+  return checksum;
+}
+
+static uint64_t bench_peak_rss() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return (uint64_t)usage.ru_maxrss >> 10; // MiB
+}
+
+int32_t main() {
+  char filename[] = "/tmp/bench_stream_XXXXXX";
+  const int fd = mkstemp(filename);
+  error(FATAL, fd < 0, "bench - could not create temporary source file ", filename, __FILE__, __LINE__);
+
+  uint64_t s_src = 0;
+  for (uint32_t i = 0; s_src < BENCH_S_SRC; i++) {
+    const char* line = BENCH_LINES[i % (sizeof(BENCH_LINES) / sizeof(BENCH_LINES[0]))];
+    const ssize_t s_line = (ssize_t)strlen(line);
+    error(FATAL, write(fd, line, (size_t)s_line) != s_line, "bench - could not write temporary source file ", filename, __FILE__, __LINE__);
+    s_src += (uint64_t)s_line;
+  }
+  close(fd);
+
+  printf("lexing %llu MiB (peak RSS before lexing: %llu MiB)\n", (unsigned long long)(s_src >> 20), (unsigned long long)bench_peak_rss());
+
+  uint64_t reference = 0;
+  {
+    lexer::RISCVStrTab*      strtab = lexer::riscv_strtab_create();
+    lexer::RISCVLexer*       lexer  = lexer::riscv_lexer_open(filename, strtab);
+    lexer::RISCVTokenStream* batch  = lexer::riscv_tokens_create(filename, strtab);
+
+    uint64_t s_tokens = 0;
+    const auto start = std::chrono::steady_clock::now();
+    while (lexer::riscv_lexer_next_batch(lexer, batch, BENCH_S_BATCH)) {
+      s_tokens += batch->s_tokens;
+      reference = bench_checksum(batch, reference);
+    }
+    const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("  streaming  %10llu tokens  %6.2f s  peak RSS %5llu MiB\n", (unsigned long long)s_tokens, t, (unsigned long long)bench_peak_rss());
+
+    lexer::riscv_tokens_free(batch);
+    lexer::riscv_lexer_close(lexer);
+    lexer::riscv_strtab_free(strtab);
+  }
+
+  {
+    lexer::RISCVStrTab* strtab = lexer::riscv_strtab_create();
+
+    const auto start = std::chrono::steady_clock::now();
+    lexer::RISCVTokenStream* tokens = lexer::lex(filename, strtab);
+    const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("  lex        %10llu tokens  %6.2f s  peak RSS %5llu MiB\n", (unsigned long long)tokens->s_tokens, t, (unsigned long long)bench_peak_rss());
+    error(FATAL, bench_checksum(tokens, 0) != reference, "bench - streaming lexer disagrees with lex", "", __FILE__, __LINE__);
+
+    lexer::riscv_tokens_free(tokens);
+    lexer::riscv_strtab_free(strtab);
+  }
+
+  unlink(filename);
+  return 0;
+}
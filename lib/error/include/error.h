@@ -3,13 +3,15 @@
 
 #include <iostream>
 
-constexpr bool DEBUG = true;
+#include "trace.h"
+
 constexpr bool FATAL = true;
 constexpr bool ERROR = false;
 
 #define error(fatal, cond, msg, var, file, line) \
   do { \
     if (cond) {\
+      trace_flush(); \
       constexpr const char* error_type = fatal ? "FATAL" : "ERROR"; \
       std::cerr << "\033[031m[" << error_type << "]\033[0m: " << msg << var << " (in " << file << " at line " << line << ")"<< std::endl; \
       if constexpr (fatal) { \
@@ -18,13 +20,4 @@ constexpr bool ERROR = false;
     } \
   } while (0);
 
-#define log(msg, var, file, line) \
-  do { \
-    if (DEBUG) { \
-      std::cerr << "\033[036m[INFO]\033[0m: " << msg << var \
-                << " (in " << file << " at line " << line << ")\n" \
-                << std::flush; \
-    } \
-  } while (0);
-
 #endif // !__ERROR_H__
@@ -0,0 +1,74 @@
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <cstdint>
+#include <type_traits>
+
+#define TRACE_LEXER  0x1
+#define TRACE_PARSER 0x2
+#define TRACE_MAPPER 0x4
+#define TRACE_ALL    (TRACE_LEXER | TRACE_PARSER | TRACE_MAPPER)
+
+/*
+ * Trace points only exist in builds made with -DRISCV_TRACE (make TRACE=1),
+ * otherwise they compile to nothing and their arguments are never evaluated.
+ * The categories to record are picked at startup from the RISCV_TRACE
+ * environment variable, e.g. RISCV_TRACE=lexer,mapper or RISCV_TRACE=all.
+ * Records go to a per thread buffer that is written to stderr when it fills
+ * up, when the thread exits and before an error is reported.
+ */
+#ifdef RISCV_TRACE
+
+extern const uint32_t trace_categories;
+
+void trace_append (const char*);
+void trace_append (const char);
+void trace_append (const int64_t);
+void trace_append (const uint64_t);
+void trace_end    ();
+void trace_flush  ();
+
+template <typename T>
+inline void trace_append_var(const T& var) {
+  if constexpr (std::is_same_v<T, char>)
+    trace_append(var);
+  else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+    trace_append((int64_t)var);
+  else if constexpr (std::is_integral_v<T>)
+    trace_append((uint64_t)var);
+  else
+    trace_append((const char*)var);
+}
+
+#define trace_enabled(category) ((trace_categories & (category)) != 0)
+
+#define trace(category, msg, var, file, line) \
+  do { \
+    if (trace_enabled(category)) { \
+      trace_append("[TRACE]: "); \
+      trace_append(msg); \
+      trace_append_var(var); \
+      trace_append(" (in "); \
+      trace_append(file); \
+      trace_append(" at line "); \
+      trace_append_var(line); \
+      trace_append(")"); \
+      trace_end(); \
+    } \
+  } while (0);
+
+#else
+
+#define trace_enabled(category) false
+#define trace_flush()
+
+#define trace(category, msg, var, file, line) \
+  do { \
+    if (false) { \
+      (void)(msg); (void)(var); (void)(file); (void)(line); \
+    } \
+  } while (0);
+
+#endif // RISCV_TRACE
+
+#endif // !__TRACE_H__
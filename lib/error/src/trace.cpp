@@ -0,0 +1,86 @@
+#include "trace.h"
+
+#ifdef RISCV_TRACE
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <unistd.h>
+
+#define TRACE_S_SINK (1 << 16)
+
+typedef struct trace_sink {
+  char     buf[TRACE_S_SINK];
+  uint32_t s_buf;
+
+  ~trace_sink() { trace_flush(); }
+} TraceSink;
+
+static thread_local TraceSink sink = { .buf = {}, .s_buf = 0 };
+
+static uint32_t _trace_categories_parse(const char* env) {
+  if (env == nullptr)
+    return 0;
+
+  uint32_t categories = 0;
+  while (*env) {
+    const char* end = strchr(env, ',');
+    const size_t s_name = end ? (size_t)(end - env) : strlen(env);
+
+    if (s_name == 5 && strncmp(env, "lexer", 5) == 0)
+      categories |= TRACE_LEXER;
+    else if (s_name == 6 && strncmp(env, "parser", 6) == 0)
+      categories |= TRACE_PARSER;
+    else if (s_name == 6 && strncmp(env, "mapper", 6) == 0)
+      categories |= TRACE_MAPPER;
+    else if (s_name == 3 && strncmp(env, "all", 3) == 0)
+      categories |= TRACE_ALL;
+
+    env += s_name + (end != nullptr);
+  }
+  return categories;
+}
+
+const uint32_t trace_categories = _trace_categories_parse(getenv("RISCV_TRACE"));
+
+void trace_append(const char* str) {
+  if (str == nullptr)
+    str = "(NULL)";
+  for (; *str; str++)
+    trace_append(*str);
+}
+
+void trace_append(const char ch) {
+  if (sink.s_buf == TRACE_S_SINK)
+    trace_flush();
+  sink.buf[sink.s_buf++] = ch;
+}
+
+void trace_append(const int64_t n) {
+  char num[24];
+  snprintf(num, sizeof(num), "%lld", (long long)n);
+  trace_append((const char*)num);
+}
+
+void trace_append(const uint64_t n) {
+  char num[24];
+  snprintf(num, sizeof(num), "%llu", (unsigned long long)n);
+  trace_append((const char*)num);
+}
+
+void trace_end() {
+  trace_append('\n');
+}
+
+void trace_flush() {
+  for (uint32_t s_written = 0; s_written < sink.s_buf;) {
+    const ssize_t s_write = write(STDERR_FILENO, sink.buf + s_written, sink.s_buf - s_written);
+    if (s_write <= 0)
+      break;
+    s_written += (uint32_t)s_write;
+  }
+  sink.s_buf = 0;
+}
+
+#endif // RISCV_TRACE
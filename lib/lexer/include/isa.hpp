@@ -0,0 +1,139 @@
+#ifndef __ISA_H__
+#define __ISA_H__
+
+#include <cstdint>
+
+// the instruction set, one row per instruction token in token order; the
+// token types, the lexer keywords, the encoder and the decoder are all
+// generated from it
+//
+// X(type, mnemonic, kind, format, opcode, funct3, funct7, rd, rs1, rs2, imm)
+//
+// kind, format, opcode and the three register columns are pasted onto
+// ISA_KIND_, ISA_FORMAT_, ISA_OPCODE_ and ISA_REG_; a register column says
+// which operand of the lowered instruction fills that field of the word and
+// imm is either ISA_IMM, the immediate or symbol operand, or a constant
+#define ISA_KIND_BASE   1 // an instruction of its own, the decoder gives these back
+#define ISA_KIND_ALIAS  2 // a base instruction with some of its operands fixed
+#define ISA_KIND_EXPAND 3 // more than one word, the mapper spells these out
+
+#define ISA_FORMAT_NONE  0
+#define ISA_FORMAT_R     1
+#define ISA_FORMAT_I     2
+#define ISA_FORMAT_SHIFT 3 // I-type with a 5 bit shift amount, funct7 sits above it
+#define ISA_FORMAT_S     4
+#define ISA_FORMAT_B     5
+#define ISA_FORMAT_U     6
+#define ISA_FORMAT_J     7
+
+#define ISA_OPCODE_NONE   0b0000000
+#define ISA_OPCODE_LOAD   0b0000011
+#define ISA_OPCODE_OP_IMM 0b0010011
+#define ISA_OPCODE_AUIPC  0b0010111
+#define ISA_OPCODE_STORE  0b0100011
+#define ISA_OPCODE_OP     0b0110011
+#define ISA_OPCODE_LUI    0b0110111
+#define ISA_OPCODE_BRANCH 0b1100011
+#define ISA_OPCODE_JALR   0b1100111
+#define ISA_OPCODE_JAL    0b1101111
+#define ISA_OPCODE_SYSTEM 0b1110011
+#define ISA_OPCODE_LNS    0b0000000 // the LNSU sits on opcode 0
+
+#define ISA_REG_NONE  0 // the format has no such field
+#define ISA_REG_RD    1
+#define ISA_REG_RS1   2
+#define ISA_REG_RS2   3
+#define ISA_REG_X0    4
+#define ISA_REG_RA    5
+#define ISA_REG_RD_RA 6 // rd, ra when the instruction was written without one
+
+#define ISA_IMM INT32_MIN
+
+#define RISCV_ISA(X) \
+  X(TOKEN_INST_32IM_NOP,        "nop",    ALIAS,  I,     OP_IMM, 0x0, 0x00, X0,    X0,   NONE, 0)       \
+                                                                                                        \
+  X(TOKEN_INST_32IM_MOVE_LI,    "li",     EXPAND, NONE,  NONE,   0x0, 0x00, RD,    NONE, NONE, ISA_IMM) \
+  X(TOKEN_INST_32IM_MOVE_LA,    "la",     EXPAND, NONE,  NONE,   0x0, 0x00, RD,    NONE, NONE, ISA_IMM) \
+  X(TOKEN_INST_32IM_MOVE_LUI,   "lui",    BASE,   U,     LUI,    0x0, 0x00, RD,    NONE, NONE, ISA_IMM) \
+  X(TOKEN_INST_32IM_MOVE_AUIPC, "auipc",  BASE,   U,     AUIPC,  0x0, 0x00, RD,    NONE, NONE, ISA_IMM) \
+  X(TOKEN_INST_32IM_MOVE_MV,    "mv",     ALIAS,  I,     OP_IMM, 0x0, 0x00, RD,    RS1,  NONE, 0)       \
+                                                                                                        \
+  X(TOKEN_INST_32IM_ALS_NEG,    "neg",    ALIAS,  R,     OP,     0x0, 0x20, RD,    X0,   RS1,  0)       \
+  X(TOKEN_INST_32IM_ALS_ADD,    "add",    BASE,   R,     OP,     0x0, 0x00, RD,    RS1,  RS2,  0)       \
+  X(TOKEN_INST_32IM_ALS_ADDI,   "addi",   BASE,   I,     OP_IMM, 0x0, 0x00, RD,    RS1,  NONE, ISA_IMM) \
+  X(TOKEN_INST_32IM_ALS_SUB,    "sub",    BASE,   R,     OP,     0x0, 0x20, RD,    RS1,  RS2,  0)       \
+  X(TOKEN_INST_32IM_ALS_NOT,    "not",    ALIAS,  I,     OP_IMM, 0x4, 0x00, RD,    RS1,  NONE, -1)      \
+  X(TOKEN_INST_32IM_ALS_AND,    "and",    BASE,   R,     OP,     0x7, 0x00, RD,    RS1,  RS2,  0)       \
+  X(TOKEN_INST_32IM_ALS_ANDI,   "andi",   BASE,   I,     OP_IMM, 0x7, 0x00, RD,    RS1,  NONE, ISA_IMM) \
+  X(TOKEN_INST_32IM_ALS_OR,     "or",     BASE,   R,     OP,     0x6, 0x00, RD,    RS1,  RS2,  0)       \
+  X(TOKEN_INST_32IM_ALS_ORI,    "ori",    BASE,   I,     OP_IMM, 0x6, 0x00, RD,    RS1,  NONE, ISA_IMM) \
+  X(TOKEN_INST_32IM_ALS_XOR,    "xor",    BASE,   R,     OP,     0x4, 0x00, RD,    RS1,  RS2,  0)       \
+  X(TOKEN_INST_32IM_ALS_XORI,   "xori",   BASE,   I,     OP_IMM, 0x4, 0x00, RD,    RS1,  NONE, ISA_IMM) \
+  X(TOKEN_INST_32IM_ALS_SLL,    "sll",    BASE,   R,     OP,     0x1, 0x00, RD,    RS1,  RS2,  0)       \
+  X(TOKEN_INST_32IM_ALS_SLLI,   "slli",   BASE,   SHIFT, OP_IMM, 0x1, 0x00, RD,    RS1,  NONE, ISA_IMM) \
+  X(TOKEN_INST_32IM_ALS_SRL,    "srl",    BASE,   R,     OP,     0x5, 0x00, RD,    RS1,  RS2,  0)       \
+  X(TOKEN_INST_32IM_ALS_SRLI,   "srli",   BASE,   SHIFT, OP_IMM, 0x5, 0x00, RD,    RS1,  NONE, ISA_IMM) \
+  X(TOKEN_INST_32IM_ALS_SRA,    "sra",    BASE,   R,     OP,     0x5, 0x20, RD,    RS1,  RS2,  0)       \
+  X(TOKEN_INST_32IM_ALS_SRAI,   "srai",   BASE,   SHIFT, OP_IMM, 0x5, 0x20, RD,    RS1,  NONE, ISA_IMM) \
+                                                                                                        \
+  X(TOKEN_INST_32IM_MD_MUL,     "mul",    BASE,   R,     OP,     0x0, 0x01, RD,    RS1,  RS2,  0)       \
+  X(TOKEN_INST_32IM_MD_MULH,    "mulh",   BASE,   R,     OP,     0x1, 0x01, RD,    RS1,  RS2,  0)       \
+  X(TOKEN_INST_32IM_MD_MULSU,   "mulsu",  BASE,   R,     OP,     0x2, 0x01, RD,    RS1,  RS2,  0)       \
+  X(TOKEN_INST_32IM_MD_MULU,    "mulu",   BASE,   R,     OP,     0x3, 0x01, RD,    RS1,  RS2,  0)       \
+  X(TOKEN_INST_32IM_MD_DIV,     "div",    BASE,   R,     OP,     0x4, 0x01, RD,    RS1,  RS2,  0)       \
+  X(TOKEN_INST_32IM_MD_DIVU,    "divu",   BASE,   R,     OP,     0x5, 0x01, RD,    RS1,  RS2,  0)       \
+  X(TOKEN_INST_32IM_MD_REM,     "rem",    BASE,   R,     OP,     0x6, 0x01, RD,    RS1,  RS2,  0)       \
+  X(TOKEN_INST_32IM_MD_REMU,    "remu",   BASE,   R,     OP,     0x7, 0x01, RD,    RS1,  RS2,  0)       \
+                                                                                                        \
+  X(TOKEN_INST_32IM_LS_LB,      "lb",     BASE,   I,     LOAD,   0x0, 0x00, RD,    RS1,  NONE, ISA_IMM) \
+  X(TOKEN_INST_32IM_LS_LH,      "lh",     BASE,   I,     LOAD,   0x1, 0x00, RD,    RS1,  NONE, ISA_IMM) \
+  X(TOKEN_INST_32IM_LS_LW,      "lw",     BASE,   I,     LOAD,   0x2, 0x00, RD,    RS1,  NONE, ISA_IMM) \
+  X(TOKEN_INST_32IM_LS_LBU,     "lbu",    BASE,   I,     LOAD,   0x4, 0x00, RD,    RS1,  NONE, ISA_IMM) \
+  X(TOKEN_INST_32IM_LS_LHU,     "lhu",    BASE,   I,     LOAD,   0x5, 0x00, RD,    RS1,  NONE, ISA_IMM) \
+  X(TOKEN_INST_32IM_LS_SB,      "sb",     BASE,   S,     STORE,  0x0, 0x00, NONE,  RS1,  RS2,  ISA_IMM) \
+  X(TOKEN_INST_32IM_LS_SH,      "sh",     BASE,   S,     STORE,  0x1, 0x00, NONE,  RS1,  RS2,  ISA_IMM) \
+  X(TOKEN_INST_32IM_LS_SW,      "sw",     BASE,   S,     STORE,  0x2, 0x00, NONE,  RS1,  RS2,  ISA_IMM) \
+                                                                                                        \
+  X(TOKEN_INST_32IM_CP_SLT,     "slt",    BASE,   R,     OP,     0x2, 0x00, RD,    RS1,  RS2,  0)       \
+  X(TOKEN_INST_32IM_CP_SLTI,    "slti",   BASE,   I,     OP_IMM, 0x2, 0x00, RD,    RS1,  NONE, ISA_IMM) \
+  X(TOKEN_INST_32IM_CP_SLTU,    "sltu",   BASE,   R,     OP,     0x3, 0x00, RD,    RS1,  RS2,  0)       \
+  X(TOKEN_INST_32IM_CP_SLTIU,   "sltiu",  BASE,   I,     OP_IMM, 0x3, 0x00, RD,    RS1,  NONE, ISA_IMM) \
+  X(TOKEN_INST_32IM_CP_SEQZ,    "seqz",   ALIAS,  I,     OP_IMM, 0x3, 0x00, RD,    RS1,  NONE, 1)       \
+  X(TOKEN_INST_32IM_CP_SNEZ,    "snez",   ALIAS,  R,     OP,     0x3, 0x00, RD,    X0,   RS1,  0)       \
+  X(TOKEN_INST_32IM_CP_SLTZ,    "sltz",   ALIAS,  R,     OP,     0x2, 0x00, RD,    RS1,  X0,   0)       \
+  X(TOKEN_INST_32IM_CP_SGTZ,    "sgtz",   ALIAS,  R,     OP,     0x2, 0x00, RD,    X0,   RS1,  0)       \
+                                                                                                        \
+  X(TOKEN_INST_32IM_FC_BEQ,     "beq",    BASE,   B,     BRANCH, 0x0, 0x00, NONE,  RS1,  RS2,  ISA_IMM) \
+  X(TOKEN_INST_32IM_FC_BNE,     "bne",    BASE,   B,     BRANCH, 0x1, 0x00, NONE,  RS1,  RS2,  ISA_IMM) \
+  X(TOKEN_INST_32IM_FC_BGT,     "bgt",    ALIAS,  B,     BRANCH, 0x4, 0x00, NONE,  RS2,  RS1,  ISA_IMM) \
+  X(TOKEN_INST_32IM_FC_BGE,     "bge",    BASE,   B,     BRANCH, 0x5, 0x00, NONE,  RS1,  RS2,  ISA_IMM) \
+  X(TOKEN_INST_32IM_FC_BLE,     "ble",    ALIAS,  B,     BRANCH, 0x5, 0x00, NONE,  RS2,  RS1,  ISA_IMM) \
+  X(TOKEN_INST_32IM_FC_BLT,     "blt",    BASE,   B,     BRANCH, 0x4, 0x00, NONE,  RS1,  RS2,  ISA_IMM) \
+  X(TOKEN_INST_32IM_FC_BGTU,    "bgtu",   ALIAS,  B,     BRANCH, 0x6, 0x00, NONE,  RS2,  RS1,  ISA_IMM) \
+  X(TOKEN_INST_32IM_FC_BGEU,    "bgeu",   BASE,   B,     BRANCH, 0x7, 0x00, NONE,  RS1,  RS2,  ISA_IMM) \
+  X(TOKEN_INST_32IM_FC_BLTU,    "bltu",   BASE,   B,     BRANCH, 0x6, 0x00, NONE,  RS1,  RS2,  ISA_IMM) \
+  X(TOKEN_INST_32IM_FC_BLEU,    "bleu",   ALIAS,  B,     BRANCH, 0x7, 0x00, NONE,  RS2,  RS1,  ISA_IMM) \
+  X(TOKEN_INST_32IM_FC_BEQZ,    "beqz",   ALIAS,  B,     BRANCH, 0x0, 0x00, NONE,  RS1,  X0,   ISA_IMM) \
+  X(TOKEN_INST_32IM_FC_BNEZ,    "bnez",   ALIAS,  B,     BRANCH, 0x1, 0x00, NONE,  RS1,  X0,   ISA_IMM) \
+  X(TOKEN_INST_32IM_FC_BLEZ,    "blez",   ALIAS,  B,     BRANCH, 0x5, 0x00, NONE,  X0,   RS1,  ISA_IMM) \
+  X(TOKEN_INST_32IM_FC_BGEZ,    "bgez",   ALIAS,  B,     BRANCH, 0x5, 0x00, NONE,  RS1,  X0,   ISA_IMM) \
+  X(TOKEN_INST_32IM_FC_BLTZ,    "bltz",   ALIAS,  B,     BRANCH, 0x4, 0x00, NONE,  RS1,  X0,   ISA_IMM) \
+  X(TOKEN_INST_32IM_FC_BGTZ,    "bgtz",   ALIAS,  B,     BRANCH, 0x4, 0x00, NONE,  X0,   RS1,  ISA_IMM) \
+  X(TOKEN_INST_32IM_FC_J,       "j",      ALIAS,  J,     JAL,    0x0, 0x00, X0,    NONE, NONE, ISA_IMM) \
+  X(TOKEN_INST_32IM_FC_JAL,     "jal",    BASE,   J,     JAL,    0x0, 0x00, RD_RA, NONE, NONE, ISA_IMM) \
+  X(TOKEN_INST_32IM_FC_JR,      "jr",     ALIAS,  I,     JALR,   0x0, 0x00, X0,    RS1,  NONE, 0)       \
+  X(TOKEN_INST_32IM_FC_JALR,    "jalr",   BASE,   I,     JALR,   0x0, 0x00, RD_RA, RS1,  NONE, ISA_IMM) \
+  X(TOKEN_INST_32IM_FC_CALL,    "call",   EXPAND, NONE,  NONE,   0x0, 0x00, RA,    NONE, NONE, ISA_IMM) \
+  X(TOKEN_INST_32IM_FC_RET,     "ret",    ALIAS,  I,     JALR,   0x0, 0x00, X0,    RA,   NONE, 0)       \
+                                                                                                        \
+  X(TOKEN_INST_32IM_OS_ECALL,   "ecall",  BASE,   I,     SYSTEM, 0x0, 0x00, X0,    X0,   NONE, 0x000)   \
+  X(TOKEN_INST_32IM_OS_EBREAK,  "ebreak", BASE,   I,     SYSTEM, 0x0, 0x00, X0,    X0,   NONE, 0x001)   \
+  X(TOKEN_INST_32IM_OS_SRET,    "sret",   BASE,   I,     SYSTEM, 0x0, 0x00, X0,    X0,   NONE, 0x102)   \
+                                                                                                        \
+  X(TOKEN_INST_32IM_LNS_ADD,    "ladd",   BASE,   R,     LNS,    0x0, 0x00, RD,    RS1,  RS2,  0)       \
+  X(TOKEN_INST_32IM_LNS_SUB,    "lsub",   BASE,   R,     LNS,    0x1, 0x00, RD,    RS1,  RS2,  0)       \
+  X(TOKEN_INST_32IM_LNS_MUL,    "lmul",   BASE,   R,     LNS,    0x2, 0x00, RD,    RS1,  RS2,  0)       \
+  X(TOKEN_INST_32IM_LNS_DIV,    "ldiv",   BASE,   R,     LNS,    0x3, 0x00, RD,    RS1,  RS2,  0)       \
+  X(TOKEN_INST_32IM_LNS_SQT,    "lsqrt",  BASE,   R,     LNS,    0x4, 0x00, RD,    RS1,  X0,   0)
+
+#endif // !__ISA_H__
@@ -13,6 +13,9 @@
 #include <cstring>
 
 #include "error.h"
+#include "isa.hpp"
+
+struct lexer_input;
 
 namespace lexer {
   enum riscv_token_type {
@@ -70,102 +73,54 @@ namespace lexer {
     TOKEN_REG_X30,
     TOKEN_REG_X31,
 
-    TOKEN_INST_32IM_NOP,
-
-    TOKEN_INST_32IM_MOVE_LI,
-    TOKEN_INST_32IM_MOVE_LA,
-    TOKEN_INST_32IM_MOVE_LUI,
-    TOKEN_INST_32IM_MOVE_AUIPC,
-    TOKEN_INST_32IM_MOVE_MV,
-
-    TOKEN_INST_32IM_ALS_NEG,
-    TOKEN_INST_32IM_ALS_ADD,
-    TOKEN_INST_32IM_ALS_ADDI,
-    TOKEN_INST_32IM_ALS_SUB,
-    TOKEN_INST_32IM_ALS_NOT,
-    TOKEN_INST_32IM_ALS_AND,
-    TOKEN_INST_32IM_ALS_ANDI,
-    TOKEN_INST_32IM_ALS_OR,
-    TOKEN_INST_32IM_ALS_ORI,
-    TOKEN_INST_32IM_ALS_XOR,
-    TOKEN_INST_32IM_ALS_XORI,
-    TOKEN_INST_32IM_ALS_SLL,
-    TOKEN_INST_32IM_ALS_SLLI,
-    TOKEN_INST_32IM_ALS_SRL,
-    TOKEN_INST_32IM_ALS_SRLI,
-    TOKEN_INST_32IM_ALS_SRA,
-    TOKEN_INST_32IM_ALS_SRAI,
-
-    TOKEN_INST_32IM_MD_MUL,
-    TOKEN_INST_32IM_MD_MULH,
-    TOKEN_INST_32IM_MD_MULSU,
-    TOKEN_INST_32IM_MD_MULU,
-    TOKEN_INST_32IM_MD_DIV,
-    TOKEN_INST_32IM_MD_DIVU,
-    TOKEN_INST_32IM_MD_REM,
-    TOKEN_INST_32IM_MD_REMU,
-
-    TOKEN_INST_32IM_LS_LB,
-    TOKEN_INST_32IM_LS_LH,
-    TOKEN_INST_32IM_LS_LW,
-    TOKEN_INST_32IM_LS_LBU,
-    TOKEN_INST_32IM_LS_LHU,
-    TOKEN_INST_32IM_LS_SB,
-    TOKEN_INST_32IM_LS_SH,
-    TOKEN_INST_32IM_LS_SW,
-
-    TOKEN_INST_32IM_CP_SLT,
-    TOKEN_INST_32IM_CP_SLTI,
-    TOKEN_INST_32IM_CP_SLTU,
-    TOKEN_INST_32IM_CP_SLTIU,
-    TOKEN_INST_32IM_CP_SEQZ,
-    TOKEN_INST_32IM_CP_SNEZ,
-    TOKEN_INST_32IM_CP_SLTZ,
-    TOKEN_INST_32IM_CP_SGTZ,
-
-    TOKEN_INST_32IM_FC_BEQ,
-    TOKEN_INST_32IM_FC_BNE,
-    TOKEN_INST_32IM_FC_BGT,
-    TOKEN_INST_32IM_FC_BGE,
-    TOKEN_INST_32IM_FC_BLE,
-    TOKEN_INST_32IM_FC_BLT,
-    TOKEN_INST_32IM_FC_BGTU,
-    TOKEN_INST_32IM_FC_BGEU,
-    TOKEN_INST_32IM_FC_BLTU,
-    TOKEN_INST_32IM_FC_BLEU,
-    TOKEN_INST_32IM_FC_BEQZ,
-    TOKEN_INST_32IM_FC_BNEZ,
-    TOKEN_INST_32IM_FC_BLEZ,
-    TOKEN_INST_32IM_FC_BGEZ,
-    TOKEN_INST_32IM_FC_BLTZ,
-    TOKEN_INST_32IM_FC_BGTZ,
-    TOKEN_INST_32IM_FC_J,
-    TOKEN_INST_32IM_FC_JAL,
-    TOKEN_INST_32IM_FC_JR,
-    TOKEN_INST_32IM_FC_JALR,
-    TOKEN_INST_32IM_FC_CALL,
-    TOKEN_INST_32IM_FC_RET,
-
-    TOKEN_INST_32IM_OS_ECALL,
-    TOKEN_INST_32IM_OS_EBREAK,
-    TOKEN_INST_32IM_OS_SRET,
-    
-    TOKEN_INST_32IM_LNS_ADD,
-    TOKEN_INST_32IM_LNS_SUB,
-    TOKEN_INST_32IM_LNS_MUL,
-    TOKEN_INST_32IM_LNS_DIV,
-    TOKEN_INST_32IM_LNS_SQT,
-    
+    // one per row of RISCV_ISA, in its order
+#define LEXER_ISA_TOKEN(type, ...) type,
+    RISCV_ISA(LEXER_ISA_TOKEN)
+#undef LEXER_ISA_TOKEN
+
     TOKEN_INST_32IM_MAX
   };
 
-  typedef enum riscv_token_type RISCVTokenType;
-  typedef struct riscv_token    RISCVToken;
+  typedef enum riscv_token_type    RISCVTokenType;
+  typedef union  riscv_token_lit     RISCVTokenLit;
+  typedef struct riscv_token_stream  RISCVTokenStream;
+  typedef struct riscv_strtab        RISCVStrTab;
+  typedef struct riscv_lexer         RISCVLexer;
+
+  RISCVTokenStream* lex                       (const char*, RISCVStrTab*);
+  RISCVTokenStream* lex_parallel              (const char*, RISCVStrTab*, const uint32_t);
+
+  RISCVLexer*     riscv_lexer_open            (const char*, RISCVStrTab*);
+  bool            riscv_lexer_next_batch      (RISCVLexer*, RISCVTokenStream*, const uint64_t);
+  void            riscv_lexer_close           (RISCVLexer*);
+
+  void            riscv_tokens_append         (RISCVTokenStream*, const RISCVTokenStream*);
+  void            riscv_tokens_drop           (RISCVTokenStream*, const uint64_t);
+  uint64_t        riscv_tokens_retain         (RISCVTokenStream*, const RISCVTokenStream*, const uint64_t);
+
+  RISCVTokenStream* riscv_tokens_create       (const char*, RISCVStrTab*);
+  void            riscv_token_print           (const RISCVTokenStream*, const uint64_t);
+  void            riscv_tokens_free           (RISCVTokenStream*);
+
+  uint32_t        riscv_tokens_get_line       (const RISCVTokenStream*, const uint64_t);
+  uint32_t        riscv_tokens_get_column     (const RISCVTokenStream*, const uint64_t);
 
-  RISCVToken*     lex                         (const char*, uint64_t&);
+  inline RISCVTokenType riscv_tokens_get_type (const RISCVTokenStream*, const uint64_t);
+  inline int32_t  riscv_tokens_get_number     (const RISCVTokenStream*, const uint64_t);
+  inline uint32_t riscv_tokens_get_id         (const RISCVTokenStream*, const uint64_t);
+  inline const char* riscv_tokens_get_string  (const RISCVTokenStream*, const uint64_t);
+  inline const char* riscv_tokens_get_source  (const RISCVTokenStream*, const uint64_t);
+  inline uint32_t riscv_tokens_get_string_size(const RISCVTokenStream*, const uint64_t);
+  void            riscv_tokens_copy_string    (const RISCVTokenStream*, const uint64_t, char*);
+  void            riscv_tokens_print_string   (const RISCVTokenStream*, const uint64_t);
 
-  void            riscv_token_print           (const RISCVToken*);
-  void            riscv_tokens_free           (RISCVToken*, const uint64_t);
+  RISCVStrTab*    riscv_strtab_create         ();
+  uint32_t        riscv_strtab_intern         (RISCVStrTab*, const char*, const uint32_t, const uint32_t);
+  const char*     riscv_strtab_get            (const RISCVStrTab*, const uint32_t);
+  uint32_t        riscv_strtab_get_size       (const RISCVStrTab*, const uint32_t);
+  void            riscv_strtab_free           (RISCVStrTab*);
+
+  inline uint32_t riscv_strtab_hash           (const char*, const uint32_t);
 
   const char*     riscv_token_get_type_string (const RISCVTokenType);
   
@@ -180,16 +135,94 @@ namespace lexer {
   inline bool     riscv_token_is_data_type    (const RISCVTokenType);
   inline bool     riscv_token_is_symbol       (const RISCVTokenType);
 
-  struct riscv_token {
-    RISCVTokenType type;
-    union {
-      char*   string;
-      int32_t number;
-    } lit;
-    uint32_t line, start, end;
-    char* filename;
+  static_assert(TOKEN_INST_32IM_MAX <= UINT8_MAX, "token types are stored in a byte");
+
+  union riscv_token_lit {
+    int32_t  number;
+    uint32_t id;       // interned string id, only for symbols
+    uint32_t s_string; // size of a string literal once its escapes are decoded
+  };
+
+  // tokens are kept as parallel arrays, 9 bytes a token, and are addressed by
+  // their index; a location is a byte offset into the file, lines are only
+  // resolved when something has to be reported
+  struct riscv_token_stream {
+    uint64_t       s_tokens, max_s_tokens;
+    uint8_t*       types;
+    RISCVTokenLit* lits;
+    uint32_t*      offsets;
+
+    uint32_t       s_lines, max_s_lines;
+    uint32_t       first_line; // line number of lines[0], batches start mid file
+    uint32_t*      lines;      // byte offset at which each line starts
+
+    const char*    filename;
+    RISCVStrTab*   strtab;
+    bool           error; // a literal was out of range, it was reported and lexed as 0
+
+    // string literals are not copied out of the source, they are read from
+    // src when they are emitted; src[0] is the byte at src_offset in the file
+    // and the stream was lexed from the s_src bytes that follow it
+    const char*          src;
+    uint64_t             src_offset, s_src;
+    uint64_t             max_s_src; // size of the copy in input when the stream made one
+    struct lexer_input*  input; // the whole input when the stream owns it
   };
 
+  // every distinct symbol and string literal is stored once, its bytes live in
+  // a bump arena that is released with a handful of frees
+  struct riscv_strtab {
+    char**    blocks;
+    uint32_t  s_blocks, max_s_blocks;
+    uint32_t  s_block;
+
+    struct riscv_strtab_entry {
+      char*    string;
+      uint32_t s_string;
+      uint32_t hash;
+    }* entries;
+    uint32_t  s_entries, max_s_entries;
+
+    uint32_t* slots; // open addressing, stores id + 1 so that 0 is an empty slot
+    uint32_t  max_s_slots;
+  };
+
+  void            riscv_strtab_borrow         (RISCVStrTab*, const struct riscv_strtab::riscv_strtab_entry*, const uint32_t);
+
+  // 32 bit FNV-1a
+  inline uint32_t riscv_strtab_hash(const char* str, const uint32_t s_str) {
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < s_str; i++)
+      hash = (hash ^ (uint8_t)str[i]) * 16777619u;
+    return hash;
+  }
+
+  // reading past the end yields TOKEN_NONE so that lookahead needs no bounds check
+  inline RISCVTokenType riscv_tokens_get_type(const RISCVTokenStream* tokens, const uint64_t i) {
+    return i < tokens->s_tokens ? (RISCVTokenType)tokens->types[i] : TOKEN_NONE;
+  }
+
+  inline int32_t riscv_tokens_get_number(const RISCVTokenStream* tokens, const uint64_t i) {
+    return tokens->lits[i].number;
+  }
+
+  inline uint32_t riscv_tokens_get_id(const RISCVTokenStream* tokens, const uint64_t i) {
+    return tokens->lits[i].id;
+  }
+
+  inline const char* riscv_tokens_get_string(const RISCVTokenStream* tokens, const uint64_t i) {
+    return riscv_strtab_get(tokens->strtab, tokens->lits[i].id);
+  }
+
+  // first byte of the token in the source, the opening quote for a string literal
+  inline const char* riscv_tokens_get_source(const RISCVTokenStream* tokens, const uint64_t i) {
+    return tokens->src + (tokens->offsets[i] - tokens->src_offset);
+  }
+
+  inline uint32_t riscv_tokens_get_string_size(const RISCVTokenStream* tokens, const uint64_t i) {
+    return tokens->lits[i].s_string;
+  }
+
   inline uint64_t riscv_token_get_type_size(const RISCVTokenType type) {
     error(
       FATAL,
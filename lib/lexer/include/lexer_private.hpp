@@ -1,9 +1,15 @@
 #ifndef __LEXER_PRIVATE_H__
 #define __LEXER_PRIVATE_H__
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 #include "lexer.hpp"
 
 #define CHAR_QUOTE   '\"'
+#define CHAR_BSLASH  '\\'
 #define CHAR_COLON   ':'
 #define CHAR_COMMA   ','
 #define CHAR_PERIOD  '.'
@@ -21,6 +27,38 @@
 #define CHAR_NEWLINE '\n'
 #define CHAR_END     '\0'
 
+#define CH_CLASS_SPACE   0x01 // horizontal whitespace, newlines are line boundaries
+#define CH_CLASS_NEWLINE 0x02
+#define CH_CLASS_ALPHA   0x04
+#define CH_CLASS_DIGIT   0x08
+#define CH_CLASS_LHEXA   0x10
+#define CH_CLASS_UHEXA   0x20
+#define CH_CLASS_BIN     0x40
+#define CH_CLASS_IDENT   0x80
+
+typedef struct lexer_ch_class_table {
+  uint8_t classes[1 << 8];
+} LexerChClassTable;
+
+constexpr LexerChClassTable _lexer_ch_class_table_build() {
+  LexerChClassTable table = {};
+  for (uint32_t ch = 0; ch < (1 << 8); ch++) {
+    uint8_t c = 0;
+    c |= (ch == CHAR_SPACE || ch == CHAR_TAB || ch == CHAR_CAR_RET || ch == CHAR_F_FEED || ch == CHAR_VTAB) ? CH_CLASS_SPACE : 0;
+    c |= ch == CHAR_NEWLINE ? CH_CLASS_NEWLINE : 0;
+    c |= ((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z')) ? CH_CLASS_ALPHA : 0;
+    c |= (ch >= '0' && ch <= '9') ? CH_CLASS_DIGIT : 0;
+    c |= (ch >= 'a' && ch <= 'f') ? CH_CLASS_LHEXA : 0;
+    c |= (ch >= 'A' && ch <= 'F') ? CH_CLASS_UHEXA : 0;
+    c |= (ch == '0' || ch == '1') ? CH_CLASS_BIN : 0;
+    c |= (c & (CH_CLASS_ALPHA | CH_CLASS_DIGIT)) || ch == CHAR_UNDER ? CH_CLASS_IDENT : 0;
+    table.classes[ch] = c;
+  }
+  return table;
+}
+
+inline constexpr LexerChClassTable LEXER_CH_CLASS = _lexer_ch_class_table_build();
+
 #define REGEX_STR_S  '\"'
 #define REGEX_HEXA_S "0(x|X)"
 #define REGEX_BIN_S  "0(b|B)"
@@ -97,102 +135,243 @@
 #define KEYWORD_X31    "x31"
 #define KEYWORD_T6     "t6"
 
-#define KEYWORD_NOP    "nop"
-#define KEYWORD_LI     "li"
-#define KEYWORD_LA     "la"
-#define KEYWORD_LUI    "lui"
-#define KEYWORD_AUIPC  "auipc"
-#define KEYWORD_MV     "mv"
-
-#define KEYWORD_NEG    "neg"
-#define KEYWORD_ADD    "add"
-#define KEYWORD_ADDI   "addi"
-#define KEYWORD_SUB    "sub"
-#define KEYWORD_NOT    "not"
-#define KEYWORD_AND    "and"
-#define KEYWORD_ANDI   "andi"
-#define KEYWORD_OR     "or"
-#define KEYWORD_ORI    "ori"
-#define KEYWORD_XOR    "xor"
-#define KEYWORD_XORI   "xori"
-#define KEYWORD_SLL    "sll"
-#define KEYWORD_SLLI   "slli"
-#define KEYWORD_SRL    "srl"
-#define KEYWORD_SRLI   "srli"
-#define KEYWORD_SRA    "sra"
-#define KEYWORD_SRAI   "srai"
-
-#define KEYWORD_MUL    "mul"
-#define KEYWORD_MULH   "mulh"
-#define KEYWORD_MULSU  "mulsu"
-#define KEYWORD_MULU   "mulu"
-#define KEYWORD_DIV    "div"
-#define KEYWORD_DIVU   "divu"
-#define KEYWORD_REM    "rem"
-#define KEYWORD_REMU   "remu"
-
-#define KEYWORD_LB     "lb"
-#define KEYWORD_LH     "lh"
-#define KEYWORD_LW     "lw"
-#define KEYWORD_LBU    "lbu"
-#define KEYWORD_LHU    "lhu"
-#define KEYWORD_SB     "sb"
-#define KEYWORD_SH     "sh"
-#define KEYWORD_SW     "sw"
-
-#define KEYWORD_SLT    "slt"
-#define KEYWORD_SLTI   "slti"
-#define KEYWORD_SLTU   "sltu"
-#define KEYWORD_SLTIU  "sltiu"
-#define KEYWORD_SEQZ   "seqz"
-#define KEYWORD_SNEZ   "snez"
-#define KEYWORD_SLTZ   "sltz"
-#define KEYWORD_SGTZ   "sgtz"
-
-#define KEYWORD_BEQ    "beq"
-#define KEYWORD_BNE    "bne"
-#define KEYWORD_BGT    "bgt"
-#define KEYWORD_BGE    "bge"
-#define KEYWORD_BLE    "ble"
-#define KEYWORD_BLT    "blt"
-#define KEYWORD_BGTU   "bgtu"
-#define KEYWORD_BGEU   "bgeu"
-#define KEYWORD_BLEU   "bleu"
-#define KEYWORD_BLTU   "bltu"
-#define KEYWORD_BEQZ   "beqz"
-#define KEYWORD_BNEZ   "bnez"
-#define KEYWORD_BLEZ   "blez"
-#define KEYWORD_BGEZ   "bgez"
-#define KEYWORD_BLTZ   "bltz"
-#define KEYWORD_BGTZ   "bgtz"
-#define KEYWORD_J      "j"
-#define KEYWORD_JAL    "jal"
-#define KEYWORD_JR     "jr"
-#define KEYWORD_JALR   "jalr"
-#define KEYWORD_CALL   "call"
-#define KEYWORD_RET    "ret"
-
-#define KEYWORD_ECALL  "ecall"
-#define KEYWORD_EBREAK "ebreak"
-#define KEYWORD_SRET   "sret"
-
-#define KEYWORD_LADD   "ladd"
-#define KEYWORD_LSUB   "lsub"
-#define KEYWORD_LMUL   "lmul"
-#define KEYWORD_LDIV   "ldiv"
-#define KEYWORD_LSQT   "lsqrt"
-
-void               _lexer_scan_line                   (lexer::RISCVToken**, uint64_t&, uint64_t&, char*, const char*, const uint32_t);
-uint32_t           _lexer_scan_str                    (lexer::RISCVToken*, uint64_t&, char*, const char*, const uint32_t, const uint32_t);
-uint32_t           _lexer_scan_hexa                   (lexer::RISCVToken*, uint64_t&, char*, const char*, const uint32_t, const uint32_t);
-uint32_t           _lexer_scan_bin                    (lexer::RISCVToken*, uint64_t&, char*, const char*, const uint32_t, const uint32_t);
-uint32_t           _lexer_scan_number                 (lexer::RISCVToken*, uint64_t&, char*, const char*, const uint32_t, const uint32_t);
+#define KEYWORD_MAX_LEN  8
+#define KEYWORD_HASH_BITS 11
+
+typedef struct lexer_keyword {
+  const char*           name;
+  lexer::RISCVTokenType type;
+} LexerKeyword;
+
+inline constexpr LexerKeyword LEXER_KEYWORDS[] = {
+  { KEYWORD_TEXT,   lexer::TOKEN_TEXT },
+  { KEYWORD_DATA,   lexer::TOKEN_DATA },
+  { KEYWORD_BYTE,   lexer::TOKEN_BYTE },
+  { KEYWORD_HALF,   lexer::TOKEN_HALF },
+  { KEYWORD_WORD,   lexer::TOKEN_WORD },
+  { KEYWORD_STRING, lexer::TOKEN_STRING },
+  { KEYWORD_ZERO,   lexer::TOKEN_REG_X0 },
+  { KEYWORD_X0,     lexer::TOKEN_REG_X0 },
+  { KEYWORD_RA,     lexer::TOKEN_REG_X1 },
+  { KEYWORD_X1,     lexer::TOKEN_REG_X1 },
+  { KEYWORD_SP,     lexer::TOKEN_REG_X2 },
+  { KEYWORD_X2,     lexer::TOKEN_REG_X2 },
+  { KEYWORD_GP,     lexer::TOKEN_REG_X3 },
+  { KEYWORD_X3,     lexer::TOKEN_REG_X3 },
+  { KEYWORD_TP,     lexer::TOKEN_REG_X4 },
+  { KEYWORD_X4,     lexer::TOKEN_REG_X4 },
+  { KEYWORD_T0,     lexer::TOKEN_REG_X5 },
+  { KEYWORD_X5,     lexer::TOKEN_REG_X5 },
+  { KEYWORD_T1,     lexer::TOKEN_REG_X6 },
+  { KEYWORD_X6,     lexer::TOKEN_REG_X6 },
+  { KEYWORD_T2,     lexer::TOKEN_REG_X7 },
+  { KEYWORD_X7,     lexer::TOKEN_REG_X7 },
+  { KEYWORD_S0,     lexer::TOKEN_REG_X8 },
+  { KEYWORD_X8,     lexer::TOKEN_REG_X8 },
+  { KEYWORD_S1,     lexer::TOKEN_REG_X9 },
+  { KEYWORD_X9,     lexer::TOKEN_REG_X9 },
+  { KEYWORD_A0,     lexer::TOKEN_REG_X10 },
+  { KEYWORD_X10,    lexer::TOKEN_REG_X10 },
+  { KEYWORD_A1,     lexer::TOKEN_REG_X11 },
+  { KEYWORD_X11,    lexer::TOKEN_REG_X11 },
+  { KEYWORD_A2,     lexer::TOKEN_REG_X12 },
+  { KEYWORD_X12,    lexer::TOKEN_REG_X12 },
+  { KEYWORD_A3,     lexer::TOKEN_REG_X13 },
+  { KEYWORD_X13,    lexer::TOKEN_REG_X13 },
+  { KEYWORD_A4,     lexer::TOKEN_REG_X14 },
+  { KEYWORD_X14,    lexer::TOKEN_REG_X14 },
+  { KEYWORD_A5,     lexer::TOKEN_REG_X15 },
+  { KEYWORD_X15,    lexer::TOKEN_REG_X15 },
+  { KEYWORD_A6,     lexer::TOKEN_REG_X16 },
+  { KEYWORD_X16,    lexer::TOKEN_REG_X16 },
+  { KEYWORD_A7,     lexer::TOKEN_REG_X17 },
+  { KEYWORD_X17,    lexer::TOKEN_REG_X17 },
+  { KEYWORD_S2,     lexer::TOKEN_REG_X18 },
+  { KEYWORD_X18,    lexer::TOKEN_REG_X18 },
+  { KEYWORD_S3,     lexer::TOKEN_REG_X19 },
+  { KEYWORD_X19,    lexer::TOKEN_REG_X19 },
+  { KEYWORD_S4,     lexer::TOKEN_REG_X20 },
+  { KEYWORD_X20,    lexer::TOKEN_REG_X20 },
+  { KEYWORD_S5,     lexer::TOKEN_REG_X21 },
+  { KEYWORD_X21,    lexer::TOKEN_REG_X21 },
+  { KEYWORD_S6,     lexer::TOKEN_REG_X22 },
+  { KEYWORD_X22,    lexer::TOKEN_REG_X22 },
+  { KEYWORD_S7,     lexer::TOKEN_REG_X23 },
+  { KEYWORD_X23,    lexer::TOKEN_REG_X23 },
+  { KEYWORD_S8,     lexer::TOKEN_REG_X24 },
+  { KEYWORD_X24,    lexer::TOKEN_REG_X24 },
+  { KEYWORD_S9,     lexer::TOKEN_REG_X25 },
+  { KEYWORD_X25,    lexer::TOKEN_REG_X25 },
+  { KEYWORD_S10,    lexer::TOKEN_REG_X26 },
+  { KEYWORD_X26,    lexer::TOKEN_REG_X26 },
+  { KEYWORD_S11,    lexer::TOKEN_REG_X27 },
+  { KEYWORD_X27,    lexer::TOKEN_REG_X27 },
+  { KEYWORD_T3,     lexer::TOKEN_REG_X28 },
+  { KEYWORD_X28,    lexer::TOKEN_REG_X28 },
+  { KEYWORD_T4,     lexer::TOKEN_REG_X29 },
+  { KEYWORD_X29,    lexer::TOKEN_REG_X29 },
+  { KEYWORD_T5,     lexer::TOKEN_REG_X30 },
+  { KEYWORD_X30,    lexer::TOKEN_REG_X30 },
+  { KEYWORD_T6,     lexer::TOKEN_REG_X31 },
+  { KEYWORD_X31,    lexer::TOKEN_REG_X31 },
+
+  // instructions come out of the ISA table
+#define LEXER_ISA_KEYWORD(type, mnemonic, ...) { mnemonic, lexer::type },
+  RISCV_ISA(LEXER_ISA_KEYWORD)
+#undef LEXER_ISA_KEYWORD
+};
+
+inline constexpr uint32_t LEXER_S_KEYWORDS = sizeof(LEXER_KEYWORDS) / sizeof(LexerKeyword);
+inline constexpr uint8_t  LEXER_KEYWORD_EMPTY = 0xFF;
+static_assert(LEXER_S_KEYWORDS < LEXER_KEYWORD_EMPTY, "lexer - keyword table does not fit the 8 bit slot index");
+
+// every keyword fits in 8 bytes, so a keyword is compared as a single packed
+// integer and hashed with one multiply-shift; the multiplier is searched at
+// compile time until no two keywords share a slot, making the hash perfect
+typedef struct lexer_keyword_table {
+  uint64_t seed;
+  uint64_t keys  [LEXER_S_KEYWORDS];
+  uint8_t  types [LEXER_S_KEYWORDS];
+  uint8_t  slots [1 << KEYWORD_HASH_BITS];
+} LexerKeywordTable;
+
+constexpr uint64_t _lexer_keyword_pack(const char* str, const uint32_t s_str) {
+  uint64_t key = 0;
+  for (uint32_t i = 0; i < s_str; i++)
+    key |= (uint64_t)(uint8_t)str[i] << (i << 3);
+  return key;
+}
+
+constexpr uint32_t _lexer_keyword_len(const char* str) {
+  uint32_t s_str = 0;
+  for (; str[s_str] != CHAR_END; s_str++);
+  return s_str;
+}
+
+constexpr uint32_t _lexer_keyword_hash(const uint64_t key, const uint64_t seed) {
+  return (uint32_t)((key * seed) >> (64 - KEYWORD_HASH_BITS));
+}
+
+constexpr LexerKeywordTable _lexer_keyword_table_build() {
+  for (uint64_t seed = 0x9E3779B97F4A7C15ull;; seed += 0xD1B54A32D192ED02ull) {
+    LexerKeywordTable table = {};
+    table.seed = seed | 1;
+    for (uint32_t i = 0; i < (1 << KEYWORD_HASH_BITS); i++)
+      table.slots[i] = LEXER_KEYWORD_EMPTY;
+
+    bool perfect = true;
+    for (uint32_t i = 0; i < LEXER_S_KEYWORDS && perfect; i++) {
+      const uint64_t key  = _lexer_keyword_pack(LEXER_KEYWORDS[i].name, _lexer_keyword_len(LEXER_KEYWORDS[i].name));
+      const uint32_t slot = _lexer_keyword_hash(key, table.seed);
+      perfect = table.slots[slot] == LEXER_KEYWORD_EMPTY;
+      table.slots[slot] = (uint8_t)i;
+      table.keys[i]     = key;
+      table.types[i]    = (uint8_t)LEXER_KEYWORDS[i].type;
+    }
+
+    if (perfect)
+      return table;
+  }
+}
+
+inline constexpr LexerKeywordTable LEXER_KEYWORD_TABLE = _lexer_keyword_table_build();
+
+
+typedef struct lexer_input {
+  char*    src;
+  uint64_t s_src;
+  bool     mapped;
+} LexerInput;
+
+LexerInput         _lexer_input_open                  (const char*);
+void               _lexer_input_close                 (LexerInput&);
+
+#define LEXER_S_WINDOW (1 << 16)
+
+namespace lexer {
+  // the streaming lexer only holds a window of the file, which is slid
+  // forward a whole batch at a time so that its string literals stay readable
+  struct riscv_lexer {
+    int         fd;
+    char*       window;
+    uint64_t    s_window, max_s_window;
+    uint64_t    cursor; // first byte of the window that is not lexed yet
+    uint64_t    offset; // file offset of window[0]
+    uint32_t    line;   // number of the line that starts at cursor
+    bool        eof;
+    const char* filename;
+    RISCVStrTab* strtab;
+  };
+}
+
+void               _lexer_window_drop                 (lexer::RISCVLexer*);
+void               _lexer_window_fill                 (lexer::RISCVLexer*);
+void               _lexer_tokens_source_push          (lexer::RISCVTokenStream*, const char*, const uint64_t);
+
+#define LEXER_MIN_S_CHUNK (1 << 20)
+
+// a newline aligned slice of the input that one thread lexes on its own,
+// with a string table of its own that is merged once every chunk is done
+typedef struct lexer_chunk {
+  char*                    begin;
+  char*                    end;
+  uint32_t                 first_line;
+  bool                     ended; // a NUL byte ended the input inside this chunk
+  lexer::RISCVStrTab*      strtab;
+  lexer::RISCVTokenStream* tokens;
+  uint32_t*                remap; // chunk string id to merged string id
+  uint64_t                 base_token;
+  uint32_t                 base_line;
+} LexerChunk;
+
+uint32_t           _lexer_chunks_split                (LexerChunk*, const uint32_t, char*, const uint64_t);
+void               _lexer_chunk_lex                   (LexerChunk*, const char*, const char*);
+void               _lexer_chunk_copy                  (const LexerChunk*, lexer::RISCVTokenStream*);
+
+bool               _lexer_scan_chunk                  (lexer::RISCVTokenStream*, const char*, char*, const char*, uint32_t);
+uint32_t           _lexer_scan_line                   (lexer::RISCVTokenStream*, char*, const uint32_t);
+uint32_t           _lexer_scan_str                    (lexer::RISCVTokenStream*, char*, const uint32_t, const uint32_t);
+uint32_t           _lexer_scan_hexa                   (lexer::RISCVTokenStream*, char*, const uint32_t, const uint32_t);
+uint32_t           _lexer_scan_bin                    (lexer::RISCVTokenStream*, char*, const uint32_t, const uint32_t);
+uint32_t           _lexer_scan_number                 (lexer::RISCVTokenStream*, char*, const uint32_t, const uint32_t);
+bool               _lexer_parse_digits                (const char*, uint32_t, const uint32_t, uint64_t&);
 uint32_t           _lexer_scan_next                   (char*, const uint32_t&, char*, const char*, const uint32_t);
 
+typedef struct lexer_scanner {
+  const char* name;
+  const char* (*find_not_space) (const char*);
+  const char* (*find_line_end)  (const char*);
+  const char* (*find_ident_end) (const char*);
+} LexerScanner;
+
+extern const LexerScanner LEXER_SCANNER_SCALAR;
+extern const LexerScanner LEXER_SCANNER_SSE2;
+extern const LexerScanner LEXER_SCANNER_AVX2;
+
+const LexerScanner& _lexer_scanner                    ();
+const char*        _lexer_find_not_space              (const char*);
+const char*        _lexer_find_line_end               (const char*);
+const char*        _lexer_find_ident_end              (const char*);
+
 uint32_t           _lexer_skip_space                  (char*);
 uint32_t           _lexer_skip_comments               (char*);
 
-lexer::RISCVToken* _lexer_tokens_realloc              (lexer::RISCVToken*, uint64_t, uint64_t&);
+void               _lexer_tokens_push                 (lexer::RISCVTokenStream*, const lexer::RISCVTokenType, const lexer::RISCVTokenLit, const uint32_t, const uint32_t);
+void               _lexer_tokens_reserve              (lexer::RISCVTokenStream*, const uint64_t, const uint32_t);
+void               _lexer_lines_push                  (lexer::RISCVTokenStream*, const uint32_t);
+void               _lexer_tokens_own_input            (lexer::RISCVTokenStream*, const LexerInput&);
+
+const char*        _lexer_string_end                  (const char*);
+bool               _lexer_escape_is_known             (const char);
+char               _lexer_escape                      (const char);
+
+#define STRTAB_S_BLOCK (1 << 12)
+
+char*              _lexer_strtab_arena_alloc          (lexer::RISCVStrTab*, const uint32_t);
+void               _lexer_strtab_blocks_push          (lexer::RISCVStrTab*, const uint32_t);
+void               _lexer_strtab_slots_grow           (lexer::RISCVStrTab*);
+
+lexer::RISCVTokenType _lexer_keyword_lookup         (const char*, const uint32_t);
 
 bool               _lexer_ch_is_regex_keyword         (const char);
 bool               _lexer_ch_is_hexa                  (const char);
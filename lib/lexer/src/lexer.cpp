@@ -1,55 +1,49 @@
 #include "lexer_private.hpp"
 
 namespace lexer {
-  RISCVToken* lex(const char* filename, uint64_t& s_tokens) {
-    std::ifstream file(filename);
-    error(FATAL, !file.is_open(), "lexer - could not open input file ", filename, __FILE__, __LINE__);
-    log("lexer - opened input file ", filename, __FILE__, __LINE__);
-
-    uint64_t max_s_tokens = 1 << 8;
-    RISCVToken* tokens = (RISCVToken*)malloc(max_s_tokens * sizeof(struct riscv_token));
-    error(FATAL, tokens == nullptr, "lexer - tokens array is a nullptr", "", __FILE__, __LINE__);
-
-    std::string line;  
-    for (uint32_t i = 1; std::getline(file, line); i++) {
-      char* str = (char*)line.c_str();
-      _lexer_scan_line(&tokens, s_tokens, max_s_tokens, str, filename, i);
-      log("lexer - scanned line ", i, __FILE__, __LINE__);
-    }
+  RISCVTokenStream* lex(const char* filename, RISCVStrTab* strtab) {
+    error(FATAL, strtab == nullptr, "lexer - string table is a NULL pointer", "", __FILE__, __LINE__);
 
-    if (s_tokens != max_s_tokens) {
-      if (s_tokens == 0) {
-        free(tokens);
-        tokens = nullptr;
-      } else {
-        tokens = (lexer::RISCVToken*)realloc(tokens, s_tokens * sizeof(struct riscv_token));
-        error(FATAL, tokens == nullptr, "lexer - tokens array is a nullptr after final reallocation", "", __FILE__, __LINE__);
-      }
-    }
+    LexerInput input = _lexer_input_open(filename);
+    trace(TRACE_LEXER, "lexer - opened input file ", filename, __FILE__, __LINE__);
 
-    file.close();
+    error(FATAL, input.s_src > UINT32_MAX, "lexer - token offsets are 32 bit, input is larger than 4 GiB: ", filename, __FILE__, __LINE__);
+
+    RISCVTokenStream* tokens = riscv_tokens_create(filename, strtab);
+    _lexer_scan_chunk(tokens, input.src, input.src, input.src + input.s_src, 1);
+
+    // string literals point into the input, so it is handed to the stream
+    _lexer_tokens_own_input(tokens, input);
     return tokens;
   }
 
-  void riscv_token_print(const RISCVToken* token) {
-    error(FATAL, token == nullptr, "lexer - token is nullptr", "", __FILE__, __LINE__);
+  void riscv_token_print(const RISCVTokenStream* tokens, const uint64_t i) {
+    error(FATAL, tokens == nullptr, "lexer - token stream is nullptr", "", __FILE__, __LINE__);
+    error(FATAL, i >= tokens->s_tokens, "lexer - token index is outside of the stream: ", i, __FILE__, __LINE__);
 
+    const RISCVTokenType type = riscv_tokens_get_type(tokens, i);
     printf("Token {\n");
-    printf("  Type: %s,\n", riscv_token_get_type_string(token->type));
+    printf("  Type: %s,\n", riscv_token_get_type_string(type));
     printf(
-      "  Location: (%s, %u, %u-%u)%c\n",
-      token->filename ? token->filename : "N/A",
-      token->line, token->start, token->end,
-      token->type == TOKEN_LIT_STRING || token->type == TOKEN_LIT_NUMBER ? ',' : '\0'
+      "  Location: (%s, %u, %u)%c\n",
+      tokens->filename ? tokens->filename : "N/A",
+      riscv_tokens_get_line(tokens, i), riscv_tokens_get_column(tokens, i),
+      type == TOKEN_LIT_STRING || type == TOKEN_LIT_NUMBER || type == TOKEN_SYMBOL ? ',' : '\0'
     );
 
-    switch (token->type) {
-      case TOKEN_LIT_STRING: case TOKEN_SYMBOL: {
-        printf("  Literal (String): \"%s\"\n", token->lit.string ? token->lit.string : "(NULL)");
+    switch (type) {
+      case TOKEN_LIT_STRING: {
+        printf("  Literal (String): ");
+        riscv_tokens_print_string(tokens, i);
+        printf("\n");
+        break;
+      }
+      case TOKEN_SYMBOL: {
+        printf("  Literal (String): \"%s\"\n", riscv_tokens_get_string(tokens, i));
         break;
       }
       case TOKEN_LIT_NUMBER: {
-        printf("  Literal (Number): %d\n", token->lit.number);
+        printf("  Literal (Number): %d\n", riscv_tokens_get_number(tokens, i));
         break;
       }
       default: {
@@ -59,15 +53,112 @@ namespace lexer {
     printf("}\n");
   } 
 
-  void riscv_tokens_free(RISCVToken* tokens, const uint64_t s_tokens) {
-   if (tokens == NULL)
+  RISCVTokenStream* riscv_tokens_create(const char* filename, RISCVStrTab* strtab) {
+    RISCVTokenStream* tokens = (RISCVTokenStream*)malloc(sizeof(struct riscv_token_stream));
+    error(FATAL, tokens == nullptr, "lexer - allocation of token stream returned a NULL pointer", "", __FILE__, __LINE__);
+
+    *tokens = (RISCVTokenStream){
+      .s_tokens     = 0,
+      .max_s_tokens = 1 << 8,
+      .types        = nullptr,
+      .lits         = nullptr,
+      .offsets      = nullptr,
+      .s_lines      = 0,
+      .max_s_lines  = 1 << 6,
+      .first_line   = 1,
+      .lines        = nullptr,
+      .filename     = filename,
+      .strtab       = strtab,
+      .error        = false,
+      .src          = nullptr,
+      .src_offset   = 0,
+      .s_src        = 0,
+      .max_s_src    = 0,
+      .input        = nullptr
+    };
+
+    tokens->types   = (uint8_t*)malloc(tokens->max_s_tokens * sizeof(uint8_t));
+    tokens->lits    = (RISCVTokenLit*)malloc(tokens->max_s_tokens * sizeof(RISCVTokenLit));
+    tokens->offsets = (uint32_t*)malloc(tokens->max_s_tokens * sizeof(uint32_t));
+    tokens->lines   = (uint32_t*)malloc(tokens->max_s_lines * sizeof(uint32_t));
+    error(
+      FATAL,
+      tokens->types == nullptr || tokens->lits == nullptr || tokens->offsets == nullptr || tokens->lines == nullptr,
+      "lexer - allocation of token stream arrays returned a NULL pointer",
+      "",
+      __FILE__,
+      __LINE__
+    );
+
+    return tokens;
+  }
+
+  void riscv_tokens_free(RISCVTokenStream* tokens) {
+    // symbols belong to the string table and are released with it
+    if (tokens == nullptr)
       return;
-    for (uint64_t i = 0; i < s_tokens; i++)
-      if (tokens[i].type == TOKEN_SYMBOL || tokens[i].type == TOKEN_LIT_STRING)
-        free(tokens[i].lit.string);
+    if (tokens->input != nullptr) {
+      _lexer_input_close(*tokens->input);
+      free(tokens->input);
+    }
+    free(tokens->types);
+    free(tokens->lits);
+    free(tokens->offsets);
+    free(tokens->lines);
     free(tokens);
   }
 
+  void riscv_tokens_copy_string(const RISCVTokenStream* tokens, const uint64_t i, char* dst) {
+    // the lexer already checked the literal is closed and its escapes are known
+    const char* str = riscv_tokens_get_source(tokens, i) + 1;
+
+    // without a backslash in its first s_string bytes the body has no escape,
+    // one would have made the source longer than what it decodes to
+    const uint32_t s_string = riscv_tokens_get_string_size(tokens, i);
+    if (memchr(str, CHAR_BSLASH, s_string) == nullptr) {
+      memcpy(dst, str, s_string);
+      return;
+    }
+
+    for (;;) {
+      const char* run = str;
+      for (; *str != CHAR_QUOTE && *str != CHAR_BSLASH; str++);
+      memcpy(dst, run, (size_t)(str - run));
+      dst += str - run;
+
+      if (*str == CHAR_QUOTE)
+        break;
+      *dst++ = _lexer_escape(str[1]);
+      str += 2;
+    }
+  }
+
+  void riscv_tokens_print_string(const RISCVTokenStream* tokens, const uint64_t i) {
+    // printed as written in the source, quotes and escapes included
+    const char* str = riscv_tokens_get_source(tokens, i);
+    fwrite(str, sizeof(char), _lexer_string_end(str) - str + 1, stdout);
+  }
+
+  uint32_t riscv_tokens_get_line(const RISCVTokenStream* tokens, const uint64_t i) {
+    error(FATAL, i >= tokens->s_tokens, "lexer - token index is outside of the stream: ", i, __FILE__, __LINE__);
+
+    // last line that starts at or before the token
+    const uint32_t offset = tokens->offsets[i];
+    uint32_t lo = 0, hi = tokens->s_lines;
+    while (hi - lo > 1) {
+      const uint32_t mid = lo + ((hi - lo) >> 1);
+      if (tokens->lines[mid] <= offset)
+        lo = mid;
+      else
+        hi = mid;
+    }
+    return tokens->first_line + lo;
+  }
+
+  uint32_t riscv_tokens_get_column(const RISCVTokenStream* tokens, const uint64_t i) {
+    return tokens->offsets[i] - tokens->lines[riscv_tokens_get_line(tokens, i) - tokens->first_line] + 1;
+  }
+
   const char* riscv_token_get_type_string(const RISCVTokenType type) {
     switch (type) {
       case lexer::TOKEN_NONE:                 return "TOKEN_NONE";
@@ -118,117 +209,105 @@ namespace lexer {
       case lexer::TOKEN_REG_X30:              return "TOKEN_REG_X30 (t5/x30)";
       case lexer::TOKEN_REG_X31:              return "TOKEN_REG_X31 (t6/x31)";
 
-      case lexer::TOKEN_INST_32IM_NOP:        return "TOKEN_INST_32IM_NOP";
-
-      case lexer::TOKEN_INST_32IM_MOVE_LI:    return "TOKEN_INST_32IM_MOVE_LI";
-      case lexer::TOKEN_INST_32IM_MOVE_LA:    return "TOKEN_INST_32IM_MOVE_LA";
-      case lexer::TOKEN_INST_32IM_MOVE_LUI:   return "TOKEN_INST_32IM_MOVE_LUI";
-      case lexer::TOKEN_INST_32IM_MOVE_AUIPC: return "TOKEN_INST_32IM_MOVE_AUIPC";
-      case lexer::TOKEN_INST_32IM_MOVE_MV:    return "TOKEN_INST_32IM_MOVE_MV";
-
-      case lexer::TOKEN_INST_32IM_ALS_NEG:    return "TOKEN_INST_32IM_ALS_NEG";
-      case lexer::TOKEN_INST_32IM_ALS_ADD:    return "TOKEN_INST_32IM_ALS_ADD";
-      case lexer::TOKEN_INST_32IM_ALS_ADDI:   return "TOKEN_INST_32IM_ALS_ADDI";
-      case lexer::TOKEN_INST_32IM_ALS_SUB:    return "TOKEN_INST_32IM_ALS_SUB";
-      case lexer::TOKEN_INST_32IM_ALS_NOT:    return "TOKEN_INST_32IM_ALS_NOT";
-      case lexer::TOKEN_INST_32IM_ALS_AND:    return "TOKEN_INST_32IM_ALS_AND";
-      case lexer::TOKEN_INST_32IM_ALS_ANDI:   return "TOKEN_INST_32IM_ALS_ANDI";
-      case lexer::TOKEN_INST_32IM_ALS_OR:     return "TOKEN_INST_32IM_ALS_OR";
-      case lexer::TOKEN_INST_32IM_ALS_ORI:    return "TOKEN_INST_32IM_ALS_ORI";
-      case lexer::TOKEN_INST_32IM_ALS_XOR:    return "TOKEN_INST_32IM_ALS_XOR";
-      case lexer::TOKEN_INST_32IM_ALS_XORI:   return "TOKEN_INST_32IM_ALS_XORI";
-      case lexer::TOKEN_INST_32IM_ALS_SLL:    return "TOKEN_INST_32IM_ALS_SLL";
-      case lexer::TOKEN_INST_32IM_ALS_SLLI:   return "TOKEN_INST_32IM_ALS_SLLI";
-      case lexer::TOKEN_INST_32IM_ALS_SRL:    return "TOKEN_INST_32IM_ALS_SRL";
-      case lexer::TOKEN_INST_32IM_ALS_SRLI:   return "TOKEN_INST_32IM_ALS_SRLI";
-      case lexer::TOKEN_INST_32IM_ALS_SRA:    return "TOKEN_INST_32IM_ALS_SRA";
-      case lexer::TOKEN_INST_32IM_ALS_SRAI:   return "TOKEN_INST_32IM_ALS_SRAI";
-
-      case lexer::TOKEN_INST_32IM_MD_MUL:     return "TOKEN_INST_32IM_MD_MUL";
-      case lexer::TOKEN_INST_32IM_MD_MULH:    return "TOKEN_INST_32IM_MD_MULH";
-      case lexer::TOKEN_INST_32IM_MD_MULSU:   return "TOKEN_INST_32IM_MD_MULSU";
-      case lexer::TOKEN_INST_32IM_MD_MULU:    return "TOKEN_INST_32IM_MD_MULU";
-      case lexer::TOKEN_INST_32IM_MD_DIV:     return "TOKEN_INST_32IM_MD_DIV";
-      case lexer::TOKEN_INST_32IM_MD_DIVU:    return "TOKEN_INST_32IM_MD_DIVU";
-      case lexer::TOKEN_INST_32IM_MD_REM:     return "TOKEN_INST_32IM_MD_REM";
-      case lexer::TOKEN_INST_32IM_MD_REMU:    return "TOKEN_INST_32IM_MD_REMU";
-
-      case lexer::TOKEN_INST_32IM_LS_LB:      return "TOKEN_INST_32IM_LS_LB";
-      case lexer::TOKEN_INST_32IM_LS_LH:      return "TOKEN_INST_32IM_LS_LH";
-      case lexer::TOKEN_INST_32IM_LS_LW:      return "TOKEN_INST_32IM_LS_LW";
-      case lexer::TOKEN_INST_32IM_LS_LBU:     return "TOKEN_INST_32IM_LS_LBU";
-      case lexer::TOKEN_INST_32IM_LS_LHU:     return "TOKEN_INST_32IM_LS_LHU";
-      case lexer::TOKEN_INST_32IM_LS_SB:      return "TOKEN_INST_32IM_LS_SB";
-      case lexer::TOKEN_INST_32IM_LS_SH:      return "TOKEN_INST_32IM_LS_SH";
-      case lexer::TOKEN_INST_32IM_LS_SW:      return "TOKEN_INST_32IM_LS_SW";
-
-      case lexer::TOKEN_INST_32IM_CP_SLT:     return "TOKEN_INST_32IM_CP_SLT";
-      case lexer::TOKEN_INST_32IM_CP_SLTI:    return "TOKEN_INST_32IM_CP_SLTI";
-      case lexer::TOKEN_INST_32IM_CP_SLTU:    return "TOKEN_INST_32IM_CP_SLTU";
-      case lexer::TOKEN_INST_32IM_CP_SLTIU:   return "TOKEN_INST_32IM_CP_SLTIU";
-      case lexer::TOKEN_INST_32IM_CP_SEQZ:    return "TOKEN_INST_32IM_CP_SEQZ";
-      case lexer::TOKEN_INST_32IM_CP_SNEZ:    return "TOKEN_INST_32IM_CP_SNEZ";
-      case lexer::TOKEN_INST_32IM_CP_SLTZ:    return "TOKEN_INST_32IM_CP_SLTZ";
-      case lexer::TOKEN_INST_32IM_CP_SGTZ:    return "TOKEN_INST_32IM_CP_SGTZ";
-
-      case lexer::TOKEN_INST_32IM_FC_BEQ:     return "TOKEN_INST_32IM_FC_BEQ";
-      case lexer::TOKEN_INST_32IM_FC_BNE:     return "TOKEN_INST_32IM_FC_BNE";
-      case lexer::TOKEN_INST_32IM_FC_BGT:     return "TOKEN_INST_32IM_FC_BGT";
-      case lexer::TOKEN_INST_32IM_FC_BGE:     return "TOKEN_INST_32IM_FC_BGE";
-      case lexer::TOKEN_INST_32IM_FC_BLE:     return "TOKEN_INST_32IM_FC_BLE";
-      case lexer::TOKEN_INST_32IM_FC_BLT:     return "TOKEN_INST_32IM_FC_BLT";
-      case lexer::TOKEN_INST_32IM_FC_BGTU:    return "TOKEN_INST_32IM_FC_BGTU";
-      case lexer::TOKEN_INST_32IM_FC_BGEU:    return "TOKEN_INST_32IM_FC_BGEU";
-      case lexer::TOKEN_INST_32IM_FC_BLTU:    return "TOKEN_INST_32IM_FC_BLTU";
-      case lexer::TOKEN_INST_32IM_FC_BLEU:    return "TOKEN_INST_32IM_FC_BLEU";
-      case lexer::TOKEN_INST_32IM_FC_BEQZ:    return "TOKEN_INST_32IM_FC_BEQZ";
-      case lexer::TOKEN_INST_32IM_FC_BNEZ:    return "TOKEN_INST_32IM_FC_BNEZ";
-      case lexer::TOKEN_INST_32IM_FC_BLEZ:    return "TOKEN_INST_32IM_FC_BLEZ";
-      case lexer::TOKEN_INST_32IM_FC_BGEZ:    return "TOKEN_INST_32IM_FC_BGEZ";
-      case lexer::TOKEN_INST_32IM_FC_BLTZ:    return "TOKEN_INST_32IM_FC_BLTZ";
-      case lexer::TOKEN_INST_32IM_FC_BGTZ:    return "TOKEN_INST_32IM_FC_BGTZ";
-      case lexer::TOKEN_INST_32IM_FC_J:       return "TOKEN_INST_32IM_FC_J";
-      case lexer::TOKEN_INST_32IM_FC_JAL:     return "TOKEN_INST_32IM_FC_JAL";
-      case lexer::TOKEN_INST_32IM_FC_JR:      return "TOKEN_INST_32IM_FC_JR";
-      case lexer::TOKEN_INST_32IM_FC_JALR:    return "TOKEN_INST_32IM_FC_JALR";
-      case lexer::TOKEN_INST_32IM_FC_CALL:    return "TOKEN_INST_32IM_FC_CALL";
-      case lexer::TOKEN_INST_32IM_FC_RET:     return "TOKEN_INST_32IM_FC_RET";
-
-      case lexer::TOKEN_INST_32IM_OS_ECALL:   return "TOKEN_INST_32IM_OS_ECALL";
-      case lexer::TOKEN_INST_32IM_OS_EBREAK:  return "TOKEN_INST_32IM_OS_EBREAK";
-      case lexer::TOKEN_INST_32IM_OS_SRET:    return "TOKEN_INST_32IM_OS_SRET";
-      
-      case lexer::TOKEN_INST_32IM_LNS_ADD:    return "TOKEN_INST_32IM_LNS_ADD";
-      case lexer::TOKEN_INST_32IM_LNS_SUB:    return "TOKEN_INST_32IM_LNS_SUB";
-      case lexer::TOKEN_INST_32IM_LNS_MUL:    return "TOKEN_INST_32IM_LNS_MUL";
-      case lexer::TOKEN_INST_32IM_LNS_DIV:    return "TOKEN_INST_32IM_LNS_DIV";
-      case lexer::TOKEN_INST_32IM_LNS_SQT:    return "TOKEN_INST_32IM_LNS_SQT";
+#define LEXER_ISA_TYPE_STRING(type, ...) case lexer::type: return #type;
+      RISCV_ISA(LEXER_ISA_TYPE_STRING)
+#undef LEXER_ISA_TYPE_STRING
 
       default:                                return "UNKNOWN_TOKEN_TYPE";
     }
   }
 }
 
-void _lexer_scan_line(
-  lexer::RISCVToken** tokens, uint64_t& s_tokens, uint64_t& max_s_tokens, char* str,
-  const char* filename, const uint32_t line
-) {
+LexerInput _lexer_input_open(const char* filename) {
+  LexerInput input = { .src = nullptr, .s_src = 0, .mapped = false };
+
+  const int fd = open(filename, O_RDONLY);
+  error(FATAL, fd < 0, "lexer - could not open input file ", filename, __FILE__, __LINE__);
+
+  struct stat st;
+  error(FATAL, fstat(fd, &st) < 0, "lexer - could not stat input file ", filename, __FILE__, __LINE__);
+
+  // mmap only zero fills the tail of the last page, so a file that ends exactly
+  // on a page boundary has no NUL after it and has to go through the read path
+  const uint64_t s_page = (uint64_t)sysconf(_SC_PAGESIZE);
+  if (S_ISREG(st.st_mode) && st.st_size > 0 && (uint64_t)st.st_size % s_page != 0) {
+    void* src = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (src != MAP_FAILED) {
+      madvise(src, (size_t)st.st_size, MADV_SEQUENTIAL);
+      close(fd);
+      input.src    = (char*)src;
+      input.s_src  = (uint64_t)st.st_size;
+      input.mapped = true;
+      trace(TRACE_LEXER, "lexer - mapped input file ", filename, __FILE__, __LINE__);
+      return input;
+    }
+  }
+
+  // pipes, character devices and anything mmap refuses are read in one go
+  uint64_t max_s_src = S_ISREG(st.st_mode) && st.st_size > 0 ? (uint64_t)st.st_size + 1 : 1 << 16;
+  input.src = (char*)malloc(max_s_src * sizeof(char));
+  error(FATAL, input.src == nullptr, "lexer - allocation of input buffer returned a NULL pointer", "", __FILE__, __LINE__);
+
+  for (;;) {
+    if (input.s_src + 1 >= max_s_src) {
+      max_s_src <<= 1;
+      input.src = (char*)realloc(input.src, max_s_src * sizeof(char));
+      error(FATAL, input.src == nullptr, "lexer - reallocation of input buffer returned a NULL pointer", "", __FILE__, __LINE__);
+    }
+
+    const ssize_t s_read = read(fd, input.src + input.s_src, max_s_src - input.s_src - 1);
+    error(FATAL, s_read < 0, "lexer - could not read input file ", filename, __FILE__, __LINE__);
+    if (s_read == 0)
+      break;
+    input.s_src += (uint64_t)s_read;
+  }
+  input.src[input.s_src] = CHAR_END;
+
+  close(fd);
+  trace(TRACE_LEXER, "lexer - read input file ", filename, __FILE__, __LINE__);
+  return input;
+}
+
+void _lexer_input_close(LexerInput& input) {
+  if (input.src == nullptr)
+    return;
+  if (input.mapped)
+    munmap(input.src, input.s_src);
+  else
+    free(input.src);
+  input.src = nullptr;
+}
+
+bool _lexer_scan_chunk(lexer::RISCVTokenStream* tokens, const char* src, char* str, const char* end, uint32_t line) {
+  // the input buffer is always NUL terminated, so lines are split in place
+  // instead of being copied out one by one
+  tokens->first_line = line;
+  for (; str < end && *str != CHAR_END; line++) {
+    _lexer_lines_push(tokens, (uint32_t)(str - src));
+    str += _lexer_scan_line(tokens, str, line);
+    if (*str == CHAR_NEWLINE)
+      str++;
+    trace(TRACE_LEXER, "lexer - scanned line ", line, __FILE__, __LINE__);
+  }
+  return str < end; // a NUL byte ended the input early
+}
+
+uint32_t _lexer_scan_line(lexer::RISCVTokenStream* tokens, char* str, const uint32_t line) {
   error(FATAL, str == nullptr, "lexer - scanned str is somehow a NULL pointer", "", __FILE__, __LINE__);
-  log("lexer - scanning line: ", str, __FILE__, __LINE__);
+  const char* filename = tokens->filename;
+  trace(TRACE_LEXER, "lexer - scanning line ", line, filename, line);
 
   const uint8_t max_s_token = 1 << 7;
-  uint32_t s_chs = 0;
-  for (uint32_t i = 1; *str != CHAR_END; i += s_chs, str += s_chs) {
+  uint32_t s_chs = 0, i = 1;
+  for (; *str != CHAR_END && *str != CHAR_NEWLINE; i += s_chs, str += s_chs) {
     s_chs = _lexer_skip_space(str) + _lexer_skip_comments(str);
-    log("lexer - skipped space and comments ", s_chs, filename, line);
+    trace(TRACE_LEXER, "lexer - skipped space and comments ", s_chs, filename, line);
     if (s_chs > 0)
       continue;
 
-    *tokens = _lexer_tokens_realloc(*tokens, s_tokens, max_s_tokens);
-    
     char token[max_s_token];
     s_chs = _lexer_scan_next(token, max_s_token, str, filename, line);
-    log("lexer - scanned next token ", token, filename, line);
+    trace(TRACE_LEXER, "lexer - scanned next token ", token, filename, line);
 
     lexer::RISCVTokenType type = lexer::TOKEN_NONE;
     if (s_chs == 1 && token[0] == CHAR_COMMA) {
@@ -239,341 +318,70 @@ void _lexer_scan_line(
       type = lexer::TOKEN_LPAREN;
     } else if (s_chs == 1 && token[0] == CHAR_RPAREN) {
       type = lexer::TOKEN_RPAREN;
-    } else if (strcmp(token, KEYWORD_TEXT) == 0) {
-      type = lexer::TOKEN_TEXT;
-    } else if (strcmp(token, KEYWORD_DATA) == 0) {
-      type = lexer::TOKEN_DATA;
-    } else if (strcmp(token, KEYWORD_BYTE) == 0) {
-      type = lexer::TOKEN_BYTE;
-    } else if (strcmp(token, KEYWORD_HALF) == 0) {
-      type = lexer::TOKEN_HALF;
-    } else if (strcmp(token, KEYWORD_WORD) == 0) {
-      type = lexer::TOKEN_WORD;
-    } else if (strcmp(token, KEYWORD_STRING) == 0) {
-      type = lexer::TOKEN_STRING;
-    } else if (strcmp(token, KEYWORD_ZERO) == 0 || strcmp(token, KEYWORD_X0) == 0) {
-      type = lexer::TOKEN_REG_X0;
-    } else if (strcmp(token, KEYWORD_RA) == 0 || strcmp(token, KEYWORD_X1) == 0) {
-      type = lexer::TOKEN_REG_X1;
-    } else if (strcmp(token, KEYWORD_SP) == 0 || strcmp(token, KEYWORD_X2) == 0) {
-      type = lexer::TOKEN_REG_X2;
-    } else if (strcmp(token, KEYWORD_GP) == 0 || strcmp(token, KEYWORD_X3) == 0) {
-      type = lexer::TOKEN_REG_X3;
-    } else if (strcmp(token, KEYWORD_TP) == 0 || strcmp(token, KEYWORD_X4) == 0) {
-      type = lexer::TOKEN_REG_X4;
-    } else if (strcmp(token, KEYWORD_T0) == 0 || strcmp(token, KEYWORD_X5) == 0) {
-      type = lexer::TOKEN_REG_X5;
-    } else if (strcmp(token, KEYWORD_T1) == 0 || strcmp(token, KEYWORD_X6) == 0) {
-      type = lexer::TOKEN_REG_X6;
-    } else if (strcmp(token, KEYWORD_T2) == 0 || strcmp(token, KEYWORD_X7) == 0) {
-      type = lexer::TOKEN_REG_X7;
-    } else if (strcmp(token, KEYWORD_S0) == 0 || strcmp(token, KEYWORD_X8) == 0) {
-      type = lexer::TOKEN_REG_X8;
-    } else if (strcmp(token, KEYWORD_S1) == 0 || strcmp(token, KEYWORD_X9) == 0) {
-      type = lexer::TOKEN_REG_X9;
-    } else if (strcmp(token, KEYWORD_A0) == 0 || strcmp(token, KEYWORD_X10) == 0) {
-      type = lexer::TOKEN_REG_X10;
-    } else if (strcmp(token, KEYWORD_A1) == 0 || strcmp(token, KEYWORD_X11) == 0) {
-      type = lexer::TOKEN_REG_X11;
-    } else if (strcmp(token, KEYWORD_A2) == 0 || strcmp(token, KEYWORD_X12) == 0) {
-      type = lexer::TOKEN_REG_X12;
-    } else if (strcmp(token, KEYWORD_A3) == 0 || strcmp(token, KEYWORD_X13) == 0) {
-      type = lexer::TOKEN_REG_X13;
-    } else if (strcmp(token, KEYWORD_A4) == 0 || strcmp(token, KEYWORD_X14) == 0) {
-      type = lexer::TOKEN_REG_X14;
-    } else if (strcmp(token, KEYWORD_A5) == 0 || strcmp(token, KEYWORD_X15) == 0) {
-      type = lexer::TOKEN_REG_X15;
-    } else if (strcmp(token, KEYWORD_A6) == 0 || strcmp(token, KEYWORD_X16) == 0) {
-      type = lexer::TOKEN_REG_X16;
-    } else if (strcmp(token, KEYWORD_A7) == 0 || strcmp(token, KEYWORD_X17) == 0) {
-      type = lexer::TOKEN_REG_X17;
-    } else if (strcmp(token, KEYWORD_S2) == 0 || strcmp(token, KEYWORD_X18) == 0) {
-      type = lexer::TOKEN_REG_X18;
-    } else if (strcmp(token, KEYWORD_S3) == 0 || strcmp(token, KEYWORD_X19) == 0) {
-      type = lexer::TOKEN_REG_X19;
-    } else if (strcmp(token, KEYWORD_S4) == 0 || strcmp(token, KEYWORD_X20) == 0) {
-      type = lexer::TOKEN_REG_X20;
-    } else if (strcmp(token, KEYWORD_S5) == 0 || strcmp(token, KEYWORD_X21) == 0) {
-      type = lexer::TOKEN_REG_X21;
-    } else if (strcmp(token, KEYWORD_S6) == 0 || strcmp(token, KEYWORD_X22) == 0) {
-      type = lexer::TOKEN_REG_X22;
-    } else if (strcmp(token, KEYWORD_S7) == 0 || strcmp(token, KEYWORD_X23) == 0) {
-      type = lexer::TOKEN_REG_X23;
-    } else if (strcmp(token, KEYWORD_S8) == 0 || strcmp(token, KEYWORD_X24) == 0) {
-      type = lexer::TOKEN_REG_X24;
-    } else if (strcmp(token, KEYWORD_S9) == 0 || strcmp(token, KEYWORD_X25) == 0) {
-      type = lexer::TOKEN_REG_X25;
-    } else if (strcmp(token, KEYWORD_S10) == 0 || strcmp(token, KEYWORD_X26) == 0) {
-      type = lexer::TOKEN_REG_X26;
-    } else if (strcmp(token, KEYWORD_S11) == 0 || strcmp(token, KEYWORD_X27) == 0) {
-      type = lexer::TOKEN_REG_X27;
-    } else if (strcmp(token, KEYWORD_T3) == 0 || strcmp(token, KEYWORD_X28) == 0) {
-      type = lexer::TOKEN_REG_X28;
-    } else if (strcmp(token, KEYWORD_T4) == 0 || strcmp(token, KEYWORD_X29) == 0) {
-      type = lexer::TOKEN_REG_X29;
-    } else if (strcmp(token, KEYWORD_T5) == 0 || strcmp(token, KEYWORD_X30) == 0) {
-      type = lexer::TOKEN_REG_X30;
-    } else if (strcmp(token, KEYWORD_T6) == 0 || strcmp(token, KEYWORD_X31) == 0) {
-      type = lexer::TOKEN_REG_X31;
-    } else if (strcmp(token, KEYWORD_NOP) == 0) {
-      type = lexer::TOKEN_INST_32IM_NOP;
-    } else if (strcmp(token, KEYWORD_LI) == 0) {
-      type = lexer::TOKEN_INST_32IM_MOVE_LI;
-    } else if (strcmp(token, KEYWORD_LA) == 0) {
-      type = lexer::TOKEN_INST_32IM_MOVE_LA;
-    } else if (strcmp(token, KEYWORD_LUI) == 0) {
-      type = lexer::TOKEN_INST_32IM_MOVE_LUI;
-    } else if (strcmp(token, KEYWORD_AUIPC) == 0) {
-      type = lexer::TOKEN_INST_32IM_MOVE_AUIPC;
-    } else if (strcmp(token, KEYWORD_MV) == 0) {
-      type = lexer::TOKEN_INST_32IM_MOVE_MV;
-    } else if (strcmp(token, KEYWORD_NEG) == 0) {
-      type = lexer::TOKEN_INST_32IM_ALS_NEG;
-    } else if (strcmp(token, KEYWORD_ADD) == 0) {
-      type = lexer::TOKEN_INST_32IM_ALS_ADD;
-    } else if (strcmp(token, KEYWORD_ADDI) == 0) {
-      type = lexer::TOKEN_INST_32IM_ALS_ADDI;
-    } else if (strcmp(token, KEYWORD_SUB) == 0) {
-      type = lexer::TOKEN_INST_32IM_ALS_SUB;
-    } else if (strcmp(token, KEYWORD_NOT) == 0) {
-      type = lexer::TOKEN_INST_32IM_ALS_NOT;
-    } else if (strcmp(token, KEYWORD_AND) == 0) {
-      type = lexer::TOKEN_INST_32IM_ALS_AND;
-    } else if (strcmp(token, KEYWORD_ANDI) == 0) {
-      type = lexer::TOKEN_INST_32IM_ALS_ANDI;
-    } else if (strcmp(token, KEYWORD_OR) == 0) {
-      type = lexer::TOKEN_INST_32IM_ALS_OR;
-    } else if (strcmp(token, KEYWORD_ORI) == 0) {
-      type = lexer::TOKEN_INST_32IM_ALS_ORI;
-    } else if (strcmp(token, KEYWORD_XOR) == 0) {
-      type = lexer::TOKEN_INST_32IM_ALS_XOR;
-    } else if (strcmp(token, KEYWORD_XORI) == 0) {
-      type = lexer::TOKEN_INST_32IM_ALS_XORI;
-    } else if (strcmp(token, KEYWORD_SLL) == 0) {
-      type = lexer::TOKEN_INST_32IM_ALS_SLL;
-    } else if (strcmp(token, KEYWORD_SLLI) == 0) {
-      type = lexer::TOKEN_INST_32IM_ALS_SLLI;
-    } else if (strcmp(token, KEYWORD_SRL) == 0) {
-      type = lexer::TOKEN_INST_32IM_ALS_SRL;
-    } else if (strcmp(token, KEYWORD_SRLI) == 0) {
-      type = lexer::TOKEN_INST_32IM_ALS_SRLI;
-    } else if (strcmp(token, KEYWORD_SRA) == 0) {
-      type = lexer::TOKEN_INST_32IM_ALS_SRA;
-    } else if (strcmp(token, KEYWORD_SRAI) == 0) {
-      type = lexer::TOKEN_INST_32IM_ALS_SRAI;
-    } else if (strcmp(token, KEYWORD_MUL) == 0) {
-      type = lexer::TOKEN_INST_32IM_MD_MUL;
-    } else if (strcmp(token, KEYWORD_MULH) == 0) {
-      type = lexer::TOKEN_INST_32IM_MD_MULH;
-    } else if (strcmp(token, KEYWORD_MULSU) == 0) {
-      type = lexer::TOKEN_INST_32IM_MD_MULSU;
-    } else if (strcmp(token, KEYWORD_MULU) == 0) {
-      type = lexer::TOKEN_INST_32IM_MD_MULU;
-    } else if (strcmp(token, KEYWORD_DIV) == 0) {
-      type = lexer::TOKEN_INST_32IM_MD_DIV;
-    } else if (strcmp(token, KEYWORD_DIVU) == 0) {
-      type = lexer::TOKEN_INST_32IM_MD_DIVU;
-    } else if (strcmp(token, KEYWORD_REM) == 0) {
-      type = lexer::TOKEN_INST_32IM_MD_REM;
-    } else if (strcmp(token, KEYWORD_REMU) == 0) {
-      type = lexer::TOKEN_INST_32IM_MD_REMU;
-    } else if (strcmp(token, KEYWORD_LB) == 0) {
-      type = lexer::TOKEN_INST_32IM_LS_LB;
-    } else if (strcmp(token, KEYWORD_LH) == 0) {
-      type = lexer::TOKEN_INST_32IM_LS_LH;
-    } else if (strcmp(token, KEYWORD_LW) == 0) {
-      type = lexer::TOKEN_INST_32IM_LS_LW;
-    } else if (strcmp(token, KEYWORD_LBU) == 0) {
-      type = lexer::TOKEN_INST_32IM_LS_LBU;
-    } else if (strcmp(token, KEYWORD_LHU) == 0) {
-      type = lexer::TOKEN_INST_32IM_LS_LHU;
-    } else if (strcmp(token, KEYWORD_SB) == 0) {
-      type = lexer::TOKEN_INST_32IM_LS_SB;
-    } else if (strcmp(token, KEYWORD_SH) == 0) {
-      type = lexer::TOKEN_INST_32IM_LS_SH;
-    } else if (strcmp(token, KEYWORD_SW) == 0) {
-      type = lexer::TOKEN_INST_32IM_LS_SW;
-    } else if (strcmp(token, KEYWORD_SLT) == 0) {
-      type = lexer::TOKEN_INST_32IM_CP_SLT;
-    } else if (strcmp(token, KEYWORD_SLTI) == 0) {
-      type = lexer::TOKEN_INST_32IM_CP_SLTI;
-    } else if (strcmp(token, KEYWORD_SLTU) == 0) {
-      type = lexer::TOKEN_INST_32IM_CP_SLTU;
-    } else if (strcmp(token, KEYWORD_SLTIU) == 0) {
-      type = lexer::TOKEN_INST_32IM_CP_SLTIU;
-    } else if (strcmp(token, KEYWORD_SEQZ) == 0) {
-      type = lexer::TOKEN_INST_32IM_CP_SEQZ;
-    } else if (strcmp(token, KEYWORD_SNEZ) == 0) {
-      type = lexer::TOKEN_INST_32IM_CP_SNEZ;
-    } else if (strcmp(token, KEYWORD_SLTZ) == 0) {
-      type = lexer::TOKEN_INST_32IM_CP_SLTZ;
-    } else if (strcmp(token, KEYWORD_SGTZ) == 0) {
-      type = lexer::TOKEN_INST_32IM_CP_SGTZ;
-    } else if (strcmp(token, KEYWORD_BEQ) == 0) {
-      type = lexer::TOKEN_INST_32IM_FC_BEQ;
-    } else if (strcmp(token, KEYWORD_BNE) == 0) {
-      type = lexer::TOKEN_INST_32IM_FC_BNE;
-    } else if (strcmp(token, KEYWORD_BGT) == 0) {
-      type = lexer::TOKEN_INST_32IM_FC_BGT;
-    } else if (strcmp(token, KEYWORD_BGE) == 0) {
-      type = lexer::TOKEN_INST_32IM_FC_BGE;
-    } else if (strcmp(token, KEYWORD_BLE) == 0) {
-      type = lexer::TOKEN_INST_32IM_FC_BLE;
-    } else if (strcmp(token, KEYWORD_BLT) == 0) {
-      type = lexer::TOKEN_INST_32IM_FC_BLT;
-    } else if (strcmp(token, KEYWORD_BGTU) == 0) {
-      type = lexer::TOKEN_INST_32IM_FC_BGTU;
-    } else if (strcmp(token, KEYWORD_BGEU) == 0) {
-      type = lexer::TOKEN_INST_32IM_FC_BGEU;
-    } else if (strcmp(token, KEYWORD_BLEU) == 0) {
-      type = lexer::TOKEN_INST_32IM_FC_BLEU;
-    } else if (strcmp(token, KEYWORD_BLTU) == 0) {
-      type = lexer::TOKEN_INST_32IM_FC_BLTU;
-    } else if (strcmp(token, KEYWORD_BEQZ) == 0) {
-      type = lexer::TOKEN_INST_32IM_FC_BEQZ;
-    } else if (strcmp(token, KEYWORD_BNEZ) == 0) {
-      type = lexer::TOKEN_INST_32IM_FC_BNEZ;
-    } else if (strcmp(token, KEYWORD_BLEZ) == 0) {
-      type = lexer::TOKEN_INST_32IM_FC_BLEZ;
-    } else if (strcmp(token, KEYWORD_BGEZ) == 0) {
-      type = lexer::TOKEN_INST_32IM_FC_BGEZ;
-    } else if (strcmp(token, KEYWORD_BLTZ) == 0) {
-      type = lexer::TOKEN_INST_32IM_FC_BLTZ;
-    } else if (strcmp(token, KEYWORD_BGTZ) == 0) {
-      type = lexer::TOKEN_INST_32IM_FC_BGTZ;
-    } else if (strcmp(token, KEYWORD_J) == 0) {
-      type = lexer::TOKEN_INST_32IM_FC_J;
-    } else if (strcmp(token, KEYWORD_JAL) == 0) {
-      type = lexer::TOKEN_INST_32IM_FC_JAL;
-    } else if (strcmp(token, KEYWORD_JR) == 0) {
-      type = lexer::TOKEN_INST_32IM_FC_JR;
-    } else if (strcmp(token, KEYWORD_JALR) == 0) {
-      type = lexer::TOKEN_INST_32IM_FC_JALR;
-    } else if (strcmp(token, KEYWORD_CALL) == 0) {
-      type = lexer::TOKEN_INST_32IM_FC_CALL;
-    } else if (strcmp(token, KEYWORD_RET) == 0) {
-      type = lexer::TOKEN_INST_32IM_FC_RET;
-    } else if (strcmp(token, KEYWORD_ECALL) == 0) {
-      type = lexer::TOKEN_INST_32IM_OS_ECALL;
-    } else if (strcmp(token, KEYWORD_EBREAK) == 0) {
-      type = lexer::TOKEN_INST_32IM_OS_EBREAK;
-    } else if (strcmp(token, KEYWORD_SRET) == 0) {
-      type = lexer::TOKEN_INST_32IM_OS_SRET;
-    } else if (strcmp(token, KEYWORD_LADD) == 0) {
-      type = lexer::TOKEN_INST_32IM_LNS_ADD;
-    } else if (strcmp(token, KEYWORD_LSUB) == 0) {
-      type = lexer::TOKEN_INST_32IM_LNS_SUB;
-    } else if (strcmp(token, KEYWORD_LMUL) == 0) {
-      type = lexer::TOKEN_INST_32IM_LNS_MUL;
-    } else if (strcmp(token, KEYWORD_LDIV) == 0) {
-      type = lexer::TOKEN_INST_32IM_LNS_DIV;
-    } else if (strcmp(token, KEYWORD_LSQT) == 0) {
-      type = lexer::TOKEN_INST_32IM_LNS_SQT;
     } else if (s_chs > 0) {
-      type = lexer::TOKEN_SYMBOL;
+      type = _lexer_keyword_lookup(token, s_chs);
     }
 
-    if (type != lexer::TOKEN_NONE) {
-      (*tokens)[s_tokens++] = (lexer::RISCVToken){
-        .type     = type,
-        .line     = line,
-        .start    = i,
-        .end      = i + s_chs - 1,
-        .filename = (char*)filename
-      };
-      if (type == lexer::TOKEN_SYMBOL) {
-        char* string = (char*)malloc((s_chs + 1) * sizeof(char));
-        error(FATAL, string == nullptr, "lexer - allocation for string scan returned a NULL pointer", "", __FILE__, __LINE__);
-        log("lexer - allocating string ", "", __FILE__, __LINE__);
-        strcpy(string, token);
-        (*tokens)[s_tokens - 1].lit.string = string;
-      }
+    if (type == lexer::TOKEN_SYMBOL) {
+      const uint32_t id = lexer::riscv_strtab_intern(tokens->strtab, str, s_chs, lexer::riscv_strtab_hash(str, s_chs));
+      _lexer_tokens_push(tokens, type, (lexer::RISCVTokenLit){ .id = id }, line, i);
+    } else if (type != lexer::TOKEN_NONE) {
+      _lexer_tokens_push(tokens, type, (lexer::RISCVTokenLit){ .number = 0 }, line, i);
     }
 
     if (s_chs == 0)
-      s_chs = _lexer_scan_str(*tokens, s_tokens, str, filename, line, i);
+      s_chs = _lexer_scan_str(tokens, str, line, i);
     if (s_chs == 0)
-      s_chs = _lexer_scan_hexa(*tokens, s_tokens, str, filename, line, i);
+      s_chs = _lexer_scan_hexa(tokens, str, line, i);
     if (s_chs == 0)
-      s_chs = _lexer_scan_bin(*tokens, s_tokens, str, filename, line, i);
+      s_chs = _lexer_scan_bin(tokens, str, line, i);
     if (s_chs == 0)
-      s_chs = _lexer_scan_number(*tokens, s_tokens, str, filename, line, i);
+      s_chs = _lexer_scan_number(tokens, str, line, i);
 
     if (s_chs == 0) {
       error(FATAL, true, "lexer - unknown keyword ", "", __FILE__, __LINE__); 
     }
-
-    if constexpr (DEBUG) {
-      riscv_token_print(&((*tokens)[s_tokens - 1]));
-    }
   }
+
+  return i - 1;
 }
 
-uint32_t _lexer_scan_str(
-  lexer::RISCVToken* tokens, uint64_t& s_tokens, char* str,
-  const char* filename, const uint32_t line, const uint32_t start
-) {
+uint32_t _lexer_scan_str(lexer::RISCVTokenStream* tokens, char* str, const uint32_t line, const uint32_t start) {
   if (*str != CHAR_QUOTE)
     return 0;
 
-  uint32_t s_string = 1 << 5;
-  char* string = (char*)malloc(s_string * sizeof(char));
-  error(FATAL, string == nullptr, "lexer - allocation for string scan returned a NULL pointer", "", __FILE__, __LINE__);
-  string[0] = CHAR_QUOTE;
-  str++;
-  log("lexer - allocating string ", "", __FILE__, __LINE__);
-
-  uint32_t s_chs = 1;
-  for (; *str != CHAR_QUOTE; s_chs++, str++) {
-    if (*str == CHAR_END) {
-      free(tokens);
-      free(string);
-      error(FATAL, true, "lexer - string ends before a ending quote (\")", line, filename, line);
-    }
-
-    if (s_chs >= s_string - 2) {
-      s_string <<= 1;
-      string = (char*)realloc(string, s_string * sizeof(char));
-      error(FATAL, string == nullptr, "lexer - reallocation for string scan returned a NULL pointer", "", __FILE__, __LINE__);
-      log("lexer - realloced string ", "", __FILE__, __LINE__);
+  // nothing is copied, only the decoded size is kept and the mapper reads the
+  // literal back out of the source when it emits it
+  uint32_t s_chs = 1, s_string = 0;
+  for (; str[s_chs] != CHAR_QUOTE; s_chs++, s_string++) {
+    if (str[s_chs] == CHAR_BSLASH) {
+      s_chs++;
+      const bool known = _lexer_escape_is_known(str[s_chs]);
+      error(
+        ERROR,
+        !known && str[s_chs] != CHAR_END && str[s_chs] != CHAR_NEWLINE,
+        "lexer - unknown escape sequence in string: \\",
+        str[s_chs],
+        tokens->filename,
+        line
+      );
+      tokens->error |= !known;
     }
-    string[s_chs] = *str;
+    error(FATAL, str[s_chs] == CHAR_END || str[s_chs] == CHAR_NEWLINE, "lexer - string ends before a ending quote (\")", "", tokens->filename, line);
   }
-  string[s_chs++] = CHAR_QUOTE;
-  string[s_chs] = CHAR_END;
-
-  tokens[s_tokens++] = (lexer::RISCVToken){
-    .type     = lexer::TOKEN_LIT_STRING,
-    .lit      = { .string = string },
-    .line     = line,
-    .start    = start,
-    .end      = start + s_chs - 1,
-    .filename = (char*)filename
-  };
-
-  log("lexer - scanned string ", string, filename, line);
+  s_chs++;
+
+  _lexer_tokens_push(tokens, lexer::TOKEN_LIT_STRING, (lexer::RISCVTokenLit){ .s_string = s_string }, line, start);
+  trace(TRACE_LEXER, "lexer - scanned string of size ", s_string, tokens->filename, line);
   
   return s_chs;
 }
 
 uint32_t _lexer_scan_next(char* token, const uint32_t& max_s_token, char* str, const char* filename, const uint32_t line) {
-  uint32_t s_chs = 0;
-  log("lexer - scanning next token", "", __FILE__, __LINE__);
+  trace(TRACE_LEXER, "lexer - scanning next token", "", __FILE__, __LINE__);
 
-  if (*str == CHAR_COMMA) {
-    token[0] = CHAR_COMMA;
-    token[1] = CHAR_END;
-    return 1;
-  } else if (*str == CHAR_COLON) {
-    token[0] = CHAR_COLON;
-    token[1] = CHAR_END;
-    return 1;
-  } else if (*str == CHAR_LPAREN) {
-    token[0] = CHAR_LPAREN;
-    token[1] = CHAR_END;
-    return 1;
-  } else if (*str == CHAR_RPAREN) {
-    token[0] = CHAR_RPAREN;
+  if (*str == CHAR_COMMA || *str == CHAR_COLON || *str == CHAR_LPAREN || *str == CHAR_RPAREN) {
+    token[0] = *str;
     token[1] = CHAR_END;
     return 1;
   }
@@ -581,165 +389,140 @@ uint32_t _lexer_scan_next(char* token, const uint32_t& max_s_token, char* str, c
   if (!(*str == CHAR_UNDER || *str == CHAR_PERIOD || _lexer_ch_is_alpha(*str))) {
     token[0] = CHAR_END;
     return 0;
-  } else {
-    token[s_chs++] = *str;
-    str++;
   }
 
-  for (; _lexer_ch_is_regex_keyword(*str); token[s_chs++] = *str, str++) {
-    if (s_chs >= max_s_token - 2)
-      token[max_s_token - 1] = CHAR_END;
-    error(ERROR, s_chs >= max_s_token - 2, "lexer - scanned token is too long, this token is probably invalid: ", token, filename, line);
-  }
+  const uint32_t s_chs = (uint32_t)(_lexer_find_ident_end(str + 1) - str);
+  const uint32_t s_token = s_chs < max_s_token - 1 ? s_chs : max_s_token - 1;
+  memcpy(token, str, s_token);
+  token[s_token] = CHAR_END;
+  error(ERROR, s_chs != s_token, "lexer - scanned token is too long, this token is probably invalid: ", token, filename, line);
 
-  token[s_chs] = CHAR_END;
   return s_chs;
 }
 
-uint32_t _lexer_scan_hexa(
-  lexer::RISCVToken* tokens, uint64_t& s_tokens, char* str,
-  const char* filename, const uint32_t line, const uint32_t start
-) {
-  if (str[0] != '0' || (str[1] != 'x' && str[1] != 'X'))
-    return 0;
-  str += 2;
-
-  log("lexer - scanning hexa number", "", __FILE__, __LINE__);
-  uint32_t n = 0, s_chs = 2;
-  for (; _lexer_ch_is_hexa(*str); s_chs++, str++) {
-    n = (n << 4) + (
-      (_lexer_ch_is_digit(*str)) * (uint32_t)(*str - '0') +
-      (_lexer_ch_is_upper_hexa(*str)) * ((uint32_t)(*str - 'A') + 10) +
-      (_lexer_ch_is_lower_hexa(*str)) * ((uint32_t)(*str - 'a') + 10)
-    );
-  }
-  log("lexer - resulting number ", (int32_t)n, __FILE__, __LINE__);
-
-  tokens[s_tokens++] = (lexer::RISCVToken){
-    .type     = lexer::TOKEN_LIT_NUMBER,
-    .lit      = { .number = (int32_t)n },
-    .line     = line,
-    .start    = start,
-    .end      = start + s_chs - 1,
-    .filename = (char*)filename
-  };
-  
-  return s_chs;
+uint32_t _lexer_skip_space(char* str) {
+  return (uint32_t)(_lexer_find_not_space(str) - str);
 }
 
-uint32_t _lexer_scan_bin(
-  lexer::RISCVToken* tokens, uint64_t& s_tokens, char* str,
-  const char* filename, const uint32_t line, const uint32_t start
-) {
-  if (str[0] != '0' || (str[1] != 'b' && str[1] != 'B'))
+uint32_t _lexer_skip_comments(char* str) {
+  if (*str != CHAR_HASH)
     return 0;
-  str += 2;
-
-  log("lexer - scanning bin number", "", __FILE__, __LINE__);
-
-  uint32_t n = 0, s_chs = 2;
-  for (; _lexer_ch_is_bin(*str); s_chs++, str++)
-    n = (n << 1) + (uint32_t)(*str == '1');
+  return (uint32_t)(_lexer_find_line_end(str) - str); // the newline is left for lex to count
+}
 
-  log("lexer - resulting number ", (int32_t)n, __FILE__, __LINE__);
+lexer::RISCVTokenType _lexer_keyword_lookup(const char* token, const uint32_t s_token) {
+  if (s_token > KEYWORD_MAX_LEN)
+    return lexer::TOKEN_SYMBOL;
 
-  tokens[s_tokens++] = (lexer::RISCVToken){
-    .type     = lexer::TOKEN_LIT_NUMBER,
-    .lit      = { .number = (int32_t)n },
-    .line     = line,
-    .start    = start,
-    .end      = start + s_chs - 1,
-    .filename = (char*)filename
-  };
-  
-  return s_chs;
+  const uint64_t key   = _lexer_keyword_pack(token, s_token);
+  const uint8_t  index = LEXER_KEYWORD_TABLE.slots[_lexer_keyword_hash(key, LEXER_KEYWORD_TABLE.seed)];
+  if (index == LEXER_KEYWORD_EMPTY || LEXER_KEYWORD_TABLE.keys[index] != key)
+    return lexer::TOKEN_SYMBOL;
+  return (lexer::RISCVTokenType)LEXER_KEYWORD_TABLE.types[index];
 }
 
-uint32_t _lexer_scan_number(
-  lexer::RISCVToken* tokens, uint64_t& s_tokens, char* str,
-  const char* filename, const uint32_t line, const uint32_t start
+void _lexer_tokens_push(
+  lexer::RISCVTokenStream* tokens, const lexer::RISCVTokenType type, const lexer::RISCVTokenLit lit,
+  const uint32_t line, const uint32_t start
 ) {
-  if (!_lexer_ch_is_digit(*str) && *str != CHAR_MINUS && *str != CHAR_PLUS)
-    return 0;
+  if (tokens->s_tokens >= tokens->max_s_tokens) {
+    trace(TRACE_LEXER, "lexer - reallocing tokens ", tokens->s_tokens, __FILE__, __LINE__);
+    _lexer_tokens_reserve(tokens, tokens->max_s_tokens << 1, 0);
+  }
 
-  log("lexer - scanning bin number", "", __FILE__, __LINE__);
+  const uint64_t i = tokens->s_tokens++;
+  tokens->types[i]   = (uint8_t)type;
+  tokens->lits[i]    = lit;
+  tokens->offsets[i] = tokens->lines[line - tokens->first_line] + start - 1;
+  trace(TRACE_LEXER, "lexer - pushed token ", lexer::riscv_token_get_type_string(type), tokens->filename, line);
+}
 
-  uint8_t sign = 0, pm = *str == CHAR_MINUS || *str == CHAR_PLUS;
-  if (pm) {
-    sign = *str == CHAR_MINUS ? 1 : 0;
-    str++;
+void _lexer_tokens_reserve(lexer::RISCVTokenStream* tokens, const uint64_t max_s_tokens, const uint32_t max_s_lines) {
+  if (max_s_tokens > tokens->max_s_tokens) {
+    tokens->max_s_tokens = max_s_tokens;
+    tokens->types   = (uint8_t*)realloc(tokens->types, tokens->max_s_tokens * sizeof(uint8_t));
+    tokens->lits    = (lexer::RISCVTokenLit*)realloc(tokens->lits, tokens->max_s_tokens * sizeof(lexer::RISCVTokenLit));
+    tokens->offsets = (uint32_t*)realloc(tokens->offsets, tokens->max_s_tokens * sizeof(uint32_t));
+    error(
+      FATAL,
+      tokens->types == nullptr || tokens->lits == nullptr || tokens->offsets == nullptr,
+      "lexer - realloc of token stream returned NULL pointer",
+      "",
+      __FILE__,
+      __LINE__
+    );
   }
 
-  uint32_t n = 0, s_chs = pm;
-  for (; _lexer_ch_is_digit(*str); s_chs++, str++)
-    n = 10 * n + (uint32_t)(*str - '0');
+  if (max_s_lines > tokens->max_s_lines) {
+    tokens->max_s_lines = max_s_lines;
+    tokens->lines = (uint32_t*)realloc(tokens->lines, tokens->max_s_lines * sizeof(uint32_t));
+    error(FATAL, tokens->lines == nullptr, "lexer - realloc of line table returned NULL pointer", "", __FILE__, __LINE__);
+  }
+}
 
-  log("lexer - resulting number ", ((sign ? -1 : 1) * (int32_t)n), __FILE__, __LINE__);
+void _lexer_lines_push(lexer::RISCVTokenStream* tokens, const uint32_t offset) {
+  if (tokens->s_lines >= tokens->max_s_lines)
+    _lexer_tokens_reserve(tokens, 0, tokens->max_s_lines << 1);
+  tokens->lines[tokens->s_lines++] = offset;
+}
 
-  tokens[s_tokens++] = (lexer::RISCVToken){
-    .type     = lexer::TOKEN_LIT_NUMBER,
-    .lit      = { .number = (sign ? -1 : 1) * (int32_t)n },
-    .line     = line,
-    .start    = start - pm,
-    .end      = start + s_chs - 1,
-    .filename = (char*)filename
-  };
-  
-  return s_chs;
+void _lexer_tokens_own_input(lexer::RISCVTokenStream* tokens, const LexerInput& input) {
+  tokens->input = (LexerInput*)malloc(sizeof(LexerInput));
+  error(FATAL, tokens->input == nullptr, "lexer - allocation of input handle returned a NULL pointer", "", __FILE__, __LINE__);
+  *tokens->input     = input;
+  tokens->src        = input.src;
+  tokens->src_offset = 0;
+  tokens->s_src      = input.s_src;
 }
 
-uint32_t _lexer_skip_space(char* str) {
-  uint32_t s_chs = 0;
-  for (; _lexer_ch_is_space(*str); s_chs++, str++);
-  return s_chs;
+const char* _lexer_string_end(const char* str) {
+  for (str++; *str != CHAR_QUOTE; str++)
+    str += *str == CHAR_BSLASH;
+  return str;
 }
 
-uint32_t _lexer_skip_comments(char* str) {
-  if (*str != CHAR_HASH)
-    return 0;
-  uint32_t s_chs = 0;
-  for (; *str != CHAR_END; s_chs++, str++); // getline function cuts the \n
-  return s_chs;
+bool _lexer_escape_is_known(const char ch) {
+  return ch == 'n' || ch == 't' || ch == 'r' || ch == '0' || ch == CHAR_BSLASH || ch == CHAR_QUOTE || ch == '\'';
 }
 
-lexer::RISCVToken* _lexer_tokens_realloc(lexer::RISCVToken* tokens, uint64_t s_tokens, uint64_t& max_s_tokens) {
-  if (s_tokens < max_s_tokens)
-    return tokens;
-  log("lexer - reallocing tokens ", s_tokens, __FILE__, __LINE__);
-  max_s_tokens <<= 1;
-  tokens = (lexer::RISCVToken*)realloc(tokens, max_s_tokens * sizeof(lexer::riscv_token));
-  error(FATAL, tokens == nullptr, "lexer - realloc of token array returned NULL pointer", "", __FILE__, __LINE__);
-  return tokens;
+char _lexer_escape(const char ch) {
+  switch (ch) {
+    case 'n': return CHAR_NEWLINE;
+    case 't': return CHAR_TAB;
+    case 'r': return CHAR_CAR_RET;
+    case '0': return CHAR_END;
+    default:  return ch; // \\, \" and \' stand for themselves, so do unknown escapes
+  }
 }
 
 bool _lexer_ch_is_regex_keyword(const char ch) {
-  return ch == CHAR_UNDER || _lexer_ch_is_alpha(ch) || _lexer_ch_is_digit(ch);
+  return LEXER_CH_CLASS.classes[(uint8_t)ch] & CH_CLASS_IDENT;
 }
 
 bool _lexer_ch_is_hexa(const char ch) {
-  return _lexer_ch_is_digit(ch) || _lexer_ch_is_lower_hexa(ch) || _lexer_ch_is_upper_hexa(ch);
+  return LEXER_CH_CLASS.classes[(uint8_t)ch] & (CH_CLASS_DIGIT | CH_CLASS_LHEXA | CH_CLASS_UHEXA);
 }
 
 bool _lexer_ch_is_digit(const char ch) {
-  return ch >= '0' && ch <= '9';
+  return LEXER_CH_CLASS.classes[(uint8_t)ch] & CH_CLASS_DIGIT;
 }
 
 bool _lexer_ch_is_lower_hexa(const char ch) {
-  return ch >= 'a' && ch <= 'f';
+  return LEXER_CH_CLASS.classes[(uint8_t)ch] & CH_CLASS_LHEXA;
 }
 
 bool _lexer_ch_is_upper_hexa(const char ch) {
-  return ch >= 'A' && ch <= 'F';
+  return LEXER_CH_CLASS.classes[(uint8_t)ch] & CH_CLASS_UHEXA;
 }
 
 bool _lexer_ch_is_bin(const char ch) {
-  return ch == '0' or ch == '1';
+  return LEXER_CH_CLASS.classes[(uint8_t)ch] & CH_CLASS_BIN;
 }
 
 bool _lexer_ch_is_space(const char ch) {
-  return ch == CHAR_NEWLINE || ch == CHAR_SPACE || ch == CHAR_TAB || ch == CHAR_CAR_RET || ch == CHAR_F_FEED || ch == CHAR_VTAB;
+  return LEXER_CH_CLASS.classes[(uint8_t)ch] & (CH_CLASS_SPACE | CH_CLASS_NEWLINE);
 }
 
 bool _lexer_ch_is_alpha(const char ch) {
-  return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z');
+  return LEXER_CH_CLASS.classes[(uint8_t)ch] & CH_CLASS_ALPHA;
 }
@@ -0,0 +1,136 @@
+#include <string_view>
+
+#include "lexer_private.hpp"
+
+/*
+ * Number literals are converted eight digits at a time: the digits are packed
+ * into a 64 bit word, first digit in the lowest byte, and adjacent lanes are
+ * folded into each other in three multiply-add steps (SWAR). A run shorter
+ * than eight digits is padded in front with '0', which is a zero digit in
+ * every radix, so only the bytes of the literal itself are ever read.
+ *
+ * Leading zeros are dropped before converting, which bounds the number of
+ * significant digits a 32 bit value can have and makes overflow detection a
+ * single compare on the 64 bit result.
+ */
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "lexer - SWAR literal parsing assumes a little endian target");
+
+#define LEXER_SWAR_ZEROS 0x3030303030303030ull
+
+static const uint64_t LEXER_POW10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+
+static inline uint64_t _lexer_swar_load(const char* digits, const uint32_t s_digits) {
+  uint64_t chunk = LEXER_SWAR_ZEROS;
+  memcpy((char*)&chunk + 8 - s_digits, digits, s_digits);
+  return chunk;
+}
+
+static inline uint64_t _lexer_swar_dec(uint64_t chunk) {
+  chunk -= LEXER_SWAR_ZEROS;
+  chunk = (chunk * 10 + (chunk >> 8)) & 0x00FF00FF00FF00FFull;
+  chunk = (chunk * 100 + (chunk >> 16)) & 0x0000FFFF0000FFFFull;
+  return (chunk * 10000 + (chunk >> 32)) & 0xFFFFFFFFull;
+}
+
+static inline uint64_t _lexer_swar_hexa(uint64_t chunk) {
+  // '0'-'9' keep their low nibble, letters have bit 6 set and are 9 short of their value
+  chunk = (chunk & 0x0F0F0F0F0F0F0F0Full) + ((chunk >> 6) & 0x0101010101010101ull) * 9;
+  chunk = ((chunk << 4) + (chunk >> 8)) & 0x00FF00FF00FF00FFull;
+  chunk = ((chunk << 8) + (chunk >> 16)) & 0x0000FFFF0000FFFFull;
+  return ((chunk << 16) + (chunk >> 32)) & 0xFFFFFFFFull;
+}
+
+static inline uint64_t _lexer_swar_bin(const uint64_t chunk) {
+  // byte i lands on bit 7 - i of the top byte, no two partial products overlap
+  return ((chunk & 0x0101010101010101ull) * 0x8040201008040201ull) >> 56;
+}
+
+static const char* _lexer_find_digits_end(const char* str, const uint8_t ch_class) {
+  for (; LEXER_CH_CLASS.classes[(uint8_t)*str] & ch_class; str++);
+  return str;
+}
+
+bool _lexer_parse_digits(const char* digits, uint32_t s_digits, const uint32_t radix, uint64_t& n) {
+  for (; s_digits > 0 && *digits == '0'; digits++, s_digits--);
+
+  const uint32_t max_s_digits = radix == 16 ? 8 : (radix == 2 ? 32 : 10);
+  n = 0;
+  if (s_digits > max_s_digits)
+    return false;
+
+  // the first chunk takes the remainder so every later chunk is a full eight
+  for (uint32_t s_chunk = (s_digits - 1) % 8 + 1; s_digits > 0; s_chunk = 8) {
+    const uint64_t chunk = _lexer_swar_load(digits, s_chunk);
+    if (radix == 16)
+      n = (n << (s_chunk << 2)) | _lexer_swar_hexa(chunk);
+    else if (radix == 2)
+      n = (n << s_chunk) | _lexer_swar_bin(chunk);
+    else
+      n = n * LEXER_POW10[s_chunk] + _lexer_swar_dec(chunk);
+    digits   += s_chunk;
+    s_digits -= s_chunk;
+  }
+
+  return n <= UINT32_MAX;
+}
+
+static void _lexer_number_push(
+  lexer::RISCVTokenStream* tokens, const char* str, const uint32_t s_chs,
+  const bool fits, const int32_t number, const uint32_t line, const uint32_t start
+) {
+  trace(TRACE_LEXER, "lexer - resulting number ", number, __FILE__, __LINE__);
+
+  // an out of range literal is reported and lexing carries on, so that every
+  // bad literal of a table shows up in one run
+  error(ERROR, !fits, "lexer - number literal does not fit in 32 bits: ", std::string_view(str, s_chs), tokens->filename, line);
+  tokens->error |= !fits;
+
+  _lexer_tokens_push(tokens, lexer::TOKEN_LIT_NUMBER, (lexer::RISCVTokenLit){ .number = fits ? number : 0 }, line, start);
+}
+
+uint32_t _lexer_scan_hexa(lexer::RISCVTokenStream* tokens, char* str, const uint32_t line, const uint32_t start) {
+  if (str[0] != '0' || (str[1] != 'x' && str[1] != 'X'))
+    return 0;
+
+  trace(TRACE_LEXER, "lexer - scanning hexa number", "", __FILE__, __LINE__);
+  const uint32_t s_digits = (uint32_t)(_lexer_find_digits_end(str + 2, CH_CLASS_DIGIT | CH_CLASS_LHEXA | CH_CLASS_UHEXA) - (str + 2));
+
+  uint64_t n;
+  const bool fits = _lexer_parse_digits(str + 2, s_digits, 16, n);
+  _lexer_number_push(tokens, str, s_digits + 2, fits, (int32_t)(uint32_t)n, line, start);
+
+  return s_digits + 2;
+}
+
+uint32_t _lexer_scan_bin(lexer::RISCVTokenStream* tokens, char* str, const uint32_t line, const uint32_t start) {
+  if (str[0] != '0' || (str[1] != 'b' && str[1] != 'B'))
+    return 0;
+
+  trace(TRACE_LEXER, "lexer - scanning bin number", "", __FILE__, __LINE__);
+  const uint32_t s_digits = (uint32_t)(_lexer_find_digits_end(str + 2, CH_CLASS_BIN) - (str + 2));
+
+  uint64_t n;
+  const bool fits = _lexer_parse_digits(str + 2, s_digits, 2, n);
+  _lexer_number_push(tokens, str, s_digits + 2, fits, (int32_t)(uint32_t)n, line, start);
+
+  return s_digits + 2;
+}
+
+uint32_t _lexer_scan_number(lexer::RISCVTokenStream* tokens, char* str, const uint32_t line, const uint32_t start) {
+  if (!_lexer_ch_is_digit(*str) && *str != CHAR_MINUS && *str != CHAR_PLUS)
+    return 0;
+
+  trace(TRACE_LEXER, "lexer - scanning decimal number", "", __FILE__, __LINE__);
+
+  const uint32_t pm   = *str == CHAR_MINUS || *str == CHAR_PLUS;
+  const bool     sign = *str == CHAR_MINUS;
+  const uint32_t s_digits = (uint32_t)(_lexer_find_digits_end(str + pm, CH_CLASS_DIGIT) - (str + pm));
+
+  // a word holds either a signed or an unsigned value, so -2^31 up to 2^32 - 1 fit
+  uint64_t n;
+  const bool fits = _lexer_parse_digits(str + pm, s_digits, 10, n) && (!sign || n <= (uint64_t)INT32_MAX + 1);
+  _lexer_number_push(tokens, str, s_digits + pm, fits, (int32_t)(sign ? 0u - (uint32_t)n : (uint32_t)n), line, start);
+
+  return s_digits + pm;
+}
@@ -0,0 +1,154 @@
+#include <thread>
+#include <vector>
+
+#include "lexer_private.hpp"
+
+namespace lexer {
+  RISCVTokenStream* lex_parallel(const char* filename, RISCVStrTab* strtab, const uint32_t s_threads) {
+    error(FATAL, strtab == nullptr, "lexer - string table is a NULL pointer", "", __FILE__, __LINE__);
+    error(FATAL, s_threads == 0, "lexer - parallel lexing needs at least one thread", "", __FILE__, __LINE__);
+
+    LexerInput input = _lexer_input_open(filename);
+    trace(TRACE_LEXER, "lexer - opened input file ", filename, __FILE__, __LINE__);
+    error(FATAL, input.s_src > UINT32_MAX, "lexer - token offsets are 32 bit, input is larger than 4 GiB: ", filename, __FILE__, __LINE__);
+
+    LexerChunk* chunks = (LexerChunk*)malloc(s_threads * sizeof(LexerChunk));
+    error(FATAL, chunks == nullptr, "lexer - allocation of input chunks returned a NULL pointer", "", __FILE__, __LINE__);
+    const uint32_t s_chunks = _lexer_chunks_split(chunks, s_threads, input.src, input.s_src);
+    trace(TRACE_LEXER, "lexer - split input into chunks: ", s_chunks, __FILE__, __LINE__);
+
+    // diagnostics need line numbers while lexing, so every chunk counts its
+    // lines first and the line each chunk starts at is their prefix sum
+    std::vector<std::thread> threads;
+    for (uint32_t c = 0; c < s_chunks; c++) {
+      threads.emplace_back([chunk = &chunks[c]]() {
+        uint32_t s_lines = 0;
+        for (const char* str = chunk->begin; str < chunk->end; str++, s_lines++) {
+          str = (const char*)memchr(str, CHAR_NEWLINE, (size_t)(chunk->end - str));
+          if (str == nullptr)
+            break;
+        }
+        chunk->first_line = s_lines;
+      });
+    }
+    for (std::thread& thread : threads)
+      thread.join();
+    threads.clear();
+
+    for (uint32_t c = 0, line = 1; c < s_chunks; c++) {
+      const uint32_t s_lines = chunks[c].first_line;
+      chunks[c].first_line = line;
+      line += s_lines;
+    }
+
+    for (uint32_t c = 0; c < s_chunks; c++)
+      threads.emplace_back(_lexer_chunk_lex, &chunks[c], filename, input.src);
+    for (std::thread& thread : threads)
+      thread.join();
+    threads.clear();
+
+    // string ids are remapped into the shared table in chunk order, which
+    // hands out the same ids lex would; chunks past one that hit a NUL byte
+    // are dropped since lex never reaches them either
+    uint64_t s_tokens = 0;
+    uint32_t s_lines = 0, s_merged = 0;
+    bool error = false;
+    while (s_merged < s_chunks) {
+      LexerChunk* chunk = &chunks[s_merged++];
+      chunk->base_token = s_tokens;
+      chunk->base_line  = s_lines;
+      s_tokens += chunk->tokens->s_tokens;
+      s_lines  += chunk->tokens->s_lines;
+      error    |= chunk->tokens->error;
+
+      chunk->remap = (uint32_t*)malloc((chunk->strtab->s_entries + 1) * sizeof(uint32_t));
+      error(FATAL, chunk->remap == nullptr, "lexer - allocation of string id remap returned a NULL pointer", "", __FILE__, __LINE__);
+      for (uint32_t id = 0; id < chunk->strtab->s_entries; id++) {
+        const struct riscv_strtab::riscv_strtab_entry* entry = &chunk->strtab->entries[id];
+        chunk->remap[id] = riscv_strtab_intern(strtab, entry->string, entry->s_string, entry->hash);
+      }
+
+      if (chunk->ended)
+        break;
+    }
+
+    RISCVTokenStream* tokens = riscv_tokens_create(filename, strtab);
+    _lexer_tokens_reserve(tokens, s_tokens, s_lines);
+    tokens->s_tokens = s_tokens;
+    tokens->s_lines  = s_lines;
+    tokens->error    = error;
+
+    for (uint32_t c = 0; c < s_merged; c++)
+      threads.emplace_back(_lexer_chunk_copy, &chunks[c], tokens);
+    for (std::thread& thread : threads)
+      thread.join();
+
+    for (uint32_t c = 0; c < s_chunks; c++) {
+      riscv_tokens_free(chunks[c].tokens);
+      riscv_strtab_free(chunks[c].strtab);
+      if (c < s_merged)
+        free(chunks[c].remap);
+    }
+    free(chunks);
+
+    _lexer_tokens_own_input(tokens, input);
+    return tokens;
+  }
+}
+
+uint32_t _lexer_chunks_split(LexerChunk* chunks, const uint32_t max_s_chunks, char* src, const uint64_t s_src) {
+  // a thread is not worth it for less than LEXER_MIN_S_CHUNK bytes
+  uint64_t s_chunks = s_src / LEXER_MIN_S_CHUNK;
+  s_chunks = s_chunks < 1 ? 1 : (s_chunks > max_s_chunks ? max_s_chunks : s_chunks);
+
+  char* const end_src = src + s_src;
+  char* begin = src;
+  uint32_t n = 0;
+  for (uint64_t c = 1; c <= s_chunks; c++) {
+    char* end = c == s_chunks ? end_src : src + s_src * c / s_chunks;
+    if (end <= begin && !(n == 0 && c == s_chunks))
+      continue; // the previous chunk ran over this one on a long line
+
+    // chunks end right after a newline so that no line is split
+    if (end < end_src) {
+      char* newline = (char*)memchr(end - 1, CHAR_NEWLINE, (size_t)(end_src - end + 1));
+      end = newline ? newline + 1 : end_src;
+    }
+
+    chunks[n++] = (LexerChunk){
+      .begin      = begin,
+      .end        = end,
+      .first_line = 0,
+      .ended      = false,
+      .strtab     = nullptr,
+      .tokens     = nullptr,
+      .remap      = nullptr,
+      .base_token = 0,
+      .base_line  = 0
+    };
+    begin = end;
+  }
+  return n;
+}
+
+void _lexer_chunk_lex(LexerChunk* chunk, const char* filename, const char* src) {
+  chunk->strtab = lexer::riscv_strtab_create();
+  chunk->tokens = lexer::riscv_tokens_create(filename, chunk->strtab);
+  chunk->tokens->src = src;
+  chunk->ended  = _lexer_scan_chunk(chunk->tokens, src, chunk->begin, chunk->end, chunk->first_line);
+}
+
+void _lexer_chunk_copy(const LexerChunk* chunk, lexer::RISCVTokenStream* tokens) {
+  const lexer::RISCVTokenStream* local = chunk->tokens;
+
+  memcpy(tokens->types + chunk->base_token, local->types, local->s_tokens * sizeof(uint8_t));
+  memcpy(tokens->offsets + chunk->base_token, local->offsets, local->s_tokens * sizeof(uint32_t));
+  memcpy(tokens->lines + chunk->base_line, local->lines, local->s_lines * sizeof(uint32_t));
+
+  for (uint64_t i = 0; i < local->s_tokens; i++) {
+    lexer::RISCVTokenLit lit = local->lits[i];
+    if (local->types[i] == lexer::TOKEN_SYMBOL)
+      lit.id = chunk->remap[lit.id];
+    tokens->lits[chunk->base_token + i] = lit;
+  }
+}
@@ -0,0 +1,194 @@
+#include "lexer_private.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define LEXER_SCAN_X86 1
+#include <immintrin.h>
+#else
+#define LEXER_SCAN_X86 0
+#endif
+
+/*
+ * Byte skipping kernels used by the lexer. Every search stops at the NUL that
+ * terminates the input buffer, so none of them needs an explicit length.
+ *
+ * The vector kernels only ever load whole aligned blocks: the first block is
+ * rounded down to its alignment and the bytes before the cursor are masked
+ * out of the result. An aligned block never straddles a page, so the bytes
+ * read past the terminator are always mapped, even at the end of an mmap.
+ */
+
+static const char* _lexer_find_not_space_scalar(const char* str) {
+  for (; LEXER_CH_CLASS.classes[(uint8_t)*str] & CH_CLASS_SPACE; str++);
+  return str;
+}
+
+static const char* _lexer_find_line_end_scalar(const char* str) {
+  for (; *str != CHAR_END && *str != CHAR_NEWLINE; str++);
+  return str;
+}
+
+static const char* _lexer_find_ident_end_scalar(const char* str) {
+  for (; LEXER_CH_CLASS.classes[(uint8_t)*str] & CH_CLASS_IDENT; str++);
+  return str;
+}
+
+const LexerScanner LEXER_SCANNER_SCALAR = {
+  .name           = "scalar",
+  .find_not_space = _lexer_find_not_space_scalar,
+  .find_line_end  = _lexer_find_line_end_scalar,
+  .find_ident_end = _lexer_find_ident_end_scalar
+};
+
+#if LEXER_SCAN_X86
+
+// separators and register names are a handful of bytes long, so the first few
+// bytes are classified one at a time before paying for a vector load
+#define LEXER_SCAN_PREFIX 8
+
+static inline __m128i _lexer_sse2_in_range(const __m128i v, const char lo, const char hi) {
+  return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+}
+
+static inline uint32_t _lexer_sse2_space(const __m128i v) {
+  const __m128i space = _mm_or_si128(
+    _mm_cmpeq_epi8(v, _mm_set1_epi8(CHAR_SPACE)),
+    _mm_andnot_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(CHAR_NEWLINE)), _lexer_sse2_in_range(v, CHAR_TAB, CHAR_CAR_RET))
+  );
+  return (uint32_t)_mm_movemask_epi8(space);
+}
+
+static inline uint32_t _lexer_sse2_line_end(const __m128i v) {
+  const __m128i end = _mm_or_si128(
+    _mm_cmpeq_epi8(v, _mm_set1_epi8(CHAR_NEWLINE)),
+    _mm_cmpeq_epi8(v, _mm_setzero_si128())
+  );
+  return (uint32_t)_mm_movemask_epi8(end);
+}
+
+static inline uint32_t _lexer_sse2_ident(const __m128i v) {
+  const __m128i ident = _mm_or_si128(
+    _mm_or_si128(
+      _lexer_sse2_in_range(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 'z'),
+      _lexer_sse2_in_range(v, '0', '9')
+    ),
+    _mm_cmpeq_epi8(v, _mm_set1_epi8(CHAR_UNDER))
+  );
+  return (uint32_t)_mm_movemask_epi8(ident);
+}
+
+#define LEXER_SSE2_FIND(name, classify, invert, prefix) \
+  static const char* name(const char* str) { \
+    for (uint32_t i = 0; i < LEXER_SCAN_PREFIX; i++, str++) \
+      if (!(prefix)) \
+        return str; \
+    const uint32_t misalign = (uint32_t)((uintptr_t)str & 15); \
+    const __m128i* block = (const __m128i*)(str - misalign); \
+    uint32_t mask = ((invert) ^ classify(_mm_load_si128(block))) & (0xFFFFu << misalign); \
+    while (mask == 0) \
+      mask = ((invert) ^ classify(_mm_load_si128(++block))) & 0xFFFFu; \
+    return (const char*)block + __builtin_ctz(mask); \
+  }
+
+LEXER_SSE2_FIND(_lexer_find_not_space_sse2, _lexer_sse2_space,    0xFFFFu, LEXER_CH_CLASS.classes[(uint8_t)*str] & CH_CLASS_SPACE)
+LEXER_SSE2_FIND(_lexer_find_line_end_sse2,  _lexer_sse2_line_end, 0x0000u, *str != CHAR_END && *str != CHAR_NEWLINE)
+LEXER_SSE2_FIND(_lexer_find_ident_end_sse2, _lexer_sse2_ident,    0xFFFFu, LEXER_CH_CLASS.classes[(uint8_t)*str] & CH_CLASS_IDENT)
+
+__attribute__((target("avx2")))
+static inline __m256i _lexer_avx2_in_range(const __m256i v, const char lo, const char hi) {
+  return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(lo - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(hi + 1), v));
+}
+
+__attribute__((target("avx2")))
+static inline uint32_t _lexer_avx2_space(const __m256i v) {
+  const __m256i space = _mm256_or_si256(
+    _mm256_cmpeq_epi8(v, _mm256_set1_epi8(CHAR_SPACE)),
+    _mm256_andnot_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(CHAR_NEWLINE)), _lexer_avx2_in_range(v, CHAR_TAB, CHAR_CAR_RET))
+  );
+  return (uint32_t)_mm256_movemask_epi8(space);
+}
+
+__attribute__((target("avx2")))
+static inline uint32_t _lexer_avx2_line_end(const __m256i v) {
+  const __m256i end = _mm256_or_si256(
+    _mm256_cmpeq_epi8(v, _mm256_set1_epi8(CHAR_NEWLINE)),
+    _mm256_cmpeq_epi8(v, _mm256_setzero_si256())
+  );
+  return (uint32_t)_mm256_movemask_epi8(end);
+}
+
+__attribute__((target("avx2")))
+static inline uint32_t _lexer_avx2_ident(const __m256i v) {
+  const __m256i ident = _mm256_or_si256(
+    _mm256_or_si256(
+      _lexer_avx2_in_range(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), 'a', 'z'),
+      _lexer_avx2_in_range(v, '0', '9')
+    ),
+    _mm256_cmpeq_epi8(v, _mm256_set1_epi8(CHAR_UNDER))
+  );
+  return (uint32_t)_mm256_movemask_epi8(ident);
+}
+
+#define LEXER_AVX2_FIND(name, classify, invert, prefix) \
+  __attribute__((target("avx2"))) \
+  static const char* name(const char* str) { \
+    for (uint32_t i = 0; i < LEXER_SCAN_PREFIX; i++, str++) \
+      if (!(prefix)) \
+        return str; \
+    const uint32_t misalign = (uint32_t)((uintptr_t)str & 31); \
+    const __m256i* block = (const __m256i*)(str - misalign); \
+    uint32_t mask = ((invert) ^ classify(_mm256_load_si256(block))) & (0xFFFFFFFFu << misalign); \
+    while (mask == 0) \
+      mask = (invert) ^ classify(_mm256_load_si256(++block)); \
+    return (const char*)block + __builtin_ctz(mask); \
+  }
+
+LEXER_AVX2_FIND(_lexer_find_not_space_avx2, _lexer_avx2_space,    0xFFFFFFFFu, LEXER_CH_CLASS.classes[(uint8_t)*str] & CH_CLASS_SPACE)
+LEXER_AVX2_FIND(_lexer_find_line_end_avx2,  _lexer_avx2_line_end, 0x00000000u, *str != CHAR_END && *str != CHAR_NEWLINE)
+LEXER_AVX2_FIND(_lexer_find_ident_end_avx2, _lexer_avx2_ident,    0xFFFFFFFFu, LEXER_CH_CLASS.classes[(uint8_t)*str] & CH_CLASS_IDENT)
+
+const LexerScanner LEXER_SCANNER_SSE2 = {
+  .name           = "sse2",
+  .find_not_space = _lexer_find_not_space_sse2,
+  .find_line_end  = _lexer_find_line_end_sse2,
+  .find_ident_end = _lexer_find_ident_end_sse2
+};
+
+const LexerScanner LEXER_SCANNER_AVX2 = {
+  .name           = "avx2",
+  .find_not_space = _lexer_find_not_space_avx2,
+  .find_line_end  = _lexer_find_line_end_avx2,
+  .find_ident_end = _lexer_find_ident_end_avx2
+};
+
+#else
+
+const LexerScanner LEXER_SCANNER_SSE2 = LEXER_SCANNER_SCALAR;
+const LexerScanner LEXER_SCANNER_AVX2 = LEXER_SCANNER_SCALAR;
+
+#endif // LEXER_SCAN_X86
+
+const LexerScanner& _lexer_scanner() {
+  static const LexerScanner& scanner = []() -> const LexerScanner& {
+#if LEXER_SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+      return LEXER_SCANNER_AVX2;
+    if (__builtin_cpu_supports("sse2"))
+      return LEXER_SCANNER_SSE2;
+#endif
+    return LEXER_SCANNER_SCALAR;
+  }();
+  return scanner;
+}
+
+const char* _lexer_find_not_space(const char* str) {
+  return _lexer_scanner().find_not_space(str);
+}
+
+const char* _lexer_find_line_end(const char* str) {
+  return _lexer_scanner().find_line_end(str);
+}
+
+const char* _lexer_find_ident_end(const char* str) {
+  return _lexer_scanner().find_ident_end(str);
+}
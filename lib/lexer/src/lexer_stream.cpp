@@ -0,0 +1,229 @@
+#include "lexer_private.hpp"
+
+namespace lexer {
+  RISCVLexer* riscv_lexer_open(const char* filename, RISCVStrTab* strtab) {
+    error(FATAL, strtab == nullptr, "lexer - string table is a NULL pointer", "", __FILE__, __LINE__);
+
+    RISCVLexer* lexer = (RISCVLexer*)malloc(sizeof(struct riscv_lexer));
+    error(FATAL, lexer == nullptr, "lexer - allocation of streaming lexer returned a NULL pointer", "", __FILE__, __LINE__);
+
+    *lexer = (RISCVLexer){
+      .fd           = open(filename, O_RDONLY),
+      .window       = (char*)malloc(LEXER_S_WINDOW * sizeof(char)),
+      .s_window     = 0,
+      .max_s_window = LEXER_S_WINDOW,
+      .cursor       = 0,
+      .offset       = 0,
+      .line         = 1,
+      .eof          = false,
+      .filename     = filename,
+      .strtab       = strtab
+    };
+    error(FATAL, lexer->fd < 0, "lexer - could not open input file ", filename, __FILE__, __LINE__);
+    error(FATAL, lexer->window == nullptr, "lexer - allocation of input window returned a NULL pointer", "", __FILE__, __LINE__);
+    lexer->window[0] = CHAR_END;
+
+    posix_fadvise(lexer->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    trace(TRACE_LEXER, "lexer - opened input stream ", filename, __FILE__, __LINE__);
+    return lexer;
+  }
+
+  bool riscv_lexer_next_batch(RISCVLexer* lexer, RISCVTokenStream* tokens, const uint64_t max_s_batch) {
+    error(FATAL, lexer == nullptr, "lexer - streaming lexer is a NULL pointer", "", __FILE__, __LINE__);
+    error(FATAL, tokens == nullptr, "lexer - token stream is a NULL pointer", "", __FILE__, __LINE__);
+    error(FATAL, tokens->strtab != lexer->strtab, "lexer - token stream and lexer use different string tables", "", __FILE__, __LINE__);
+
+    // the batch is reused, only its arrays outlive the previous call, and the
+    // source of the previous batch is dropped with it
+    _lexer_window_drop(lexer);
+    tokens->s_tokens   = 0;
+    tokens->s_lines    = 0;
+    tokens->first_line = lexer->line;
+
+    // whole lines are lexed until the batch is full, so a batch can run over
+    // max_s_batch by the tokens of its last line
+    while (tokens->s_tokens < max_s_batch) {
+      char* str = lexer->window + lexer->cursor;
+      const uint64_t s_left = lexer->s_window - lexer->cursor;
+
+      if (memchr(str, CHAR_NEWLINE, s_left) == nullptr) {
+        if (!lexer->eof) {
+          _lexer_window_fill(lexer);
+          continue;
+        }
+        if (s_left == 0)
+          break;
+      }
+
+      error(
+        FATAL,
+        lexer->offset + lexer->cursor > UINT32_MAX,
+        "lexer - token offsets are 32 bit, input is larger than 4 GiB: ",
+        lexer->filename,
+        __FILE__,
+        __LINE__
+      );
+      _lexer_lines_push(tokens, (uint32_t)(lexer->offset + lexer->cursor));
+      const uint32_t s_line = _lexer_scan_line(tokens, str, lexer->line);
+      trace(TRACE_LEXER, "lexer - scanned line ", lexer->line, __FILE__, __LINE__);
+
+      // a NUL byte ends the input, the same as it does for lex
+      if (str[s_line] == CHAR_END) {
+        lexer->cursor = lexer->s_window;
+        lexer->eof    = true;
+      } else {
+        lexer->cursor += s_line + 1;
+      }
+      lexer->line++;
+    }
+
+    // string literals of the batch are read from the window until the next call,
+    // which is only known now since the window can move while it grows
+    tokens->src        = lexer->window;
+    tokens->src_offset = lexer->offset;
+    tokens->s_src      = lexer->cursor;
+    return tokens->s_tokens > 0;
+  }
+
+  void riscv_lexer_close(RISCVLexer* lexer) {
+    if (lexer == nullptr)
+      return;
+    close(lexer->fd);
+    free(lexer->window);
+    free(lexer);
+  }
+
+  void riscv_tokens_append(RISCVTokenStream* tokens, const RISCVTokenStream* batch) {
+    error(FATAL, tokens == nullptr || batch == nullptr, "lexer - token stream is a NULL pointer", "", __FILE__, __LINE__);
+
+    // the copy has to stay a contiguous piece of the file, offsets and lines
+    // keep meaning what they meant in the batch
+    if (tokens->s_tokens == 0 && tokens->s_lines == 0 && tokens->s_src == 0) {
+      tokens->first_line = batch->first_line;
+      tokens->src_offset = batch->src_offset;
+    }
+    error(
+      FATAL,
+      batch->src_offset != tokens->src_offset + tokens->s_src || batch->first_line != tokens->first_line + tokens->s_lines,
+      "lexer - appended batch does not continue the token stream of ",
+      tokens->filename,
+      __FILE__,
+      __LINE__
+    );
+
+    _lexer_tokens_reserve(
+      tokens,
+      tokens->s_tokens + batch->s_tokens > tokens->max_s_tokens ? (tokens->s_tokens + batch->s_tokens) << 1 : 0,
+      tokens->s_lines + batch->s_lines > tokens->max_s_lines ? (tokens->s_lines + batch->s_lines) << 1 : 0
+    );
+    memcpy(tokens->types + tokens->s_tokens, batch->types, batch->s_tokens * sizeof(uint8_t));
+    memcpy(tokens->lits + tokens->s_tokens, batch->lits, batch->s_tokens * sizeof(RISCVTokenLit));
+    memcpy(tokens->offsets + tokens->s_tokens, batch->offsets, batch->s_tokens * sizeof(uint32_t));
+    memcpy(tokens->lines + tokens->s_lines, batch->lines, batch->s_lines * sizeof(uint32_t));
+    tokens->s_tokens += batch->s_tokens;
+    tokens->s_lines  += batch->s_lines;
+    tokens->error    |= batch->error;
+
+    _lexer_tokens_source_push(tokens, batch->src, batch->s_src);
+  }
+
+  void riscv_tokens_drop(RISCVTokenStream* tokens, const uint64_t i) {
+    error(FATAL, tokens == nullptr, "lexer - token stream is a NULL pointer", "", __FILE__, __LINE__);
+    error(FATAL, tokens->s_src > 0 && tokens->max_s_src == 0, "lexer - only a stream with a copy of its source can drop tokens", "", __FILE__, __LINE__);
+
+    if (i >= tokens->s_tokens) {
+      tokens->first_line += tokens->s_lines;
+      tokens->src_offset += tokens->s_src;
+      tokens->s_tokens = tokens->s_lines = 0;
+      tokens->s_src    = 0;
+      return;
+    }
+
+    // the line token i is on is kept whole, so are its lines and bytes after it
+    const uint32_t line  = riscv_tokens_get_line(tokens, i) - tokens->first_line;
+    const uint64_t start = tokens->lines[line] - tokens->src_offset;
+
+    tokens->s_tokens -= i;
+    memmove(tokens->types, tokens->types + i, tokens->s_tokens * sizeof(uint8_t));
+    memmove(tokens->lits, tokens->lits + i, tokens->s_tokens * sizeof(RISCVTokenLit));
+    memmove(tokens->offsets, tokens->offsets + i, tokens->s_tokens * sizeof(uint32_t));
+
+    tokens->s_lines    -= line;
+    tokens->first_line += line;
+    memmove(tokens->lines, tokens->lines + line, tokens->s_lines * sizeof(uint32_t));
+
+    tokens->s_src      -= start;
+    tokens->src_offset += start;
+    memmove(tokens->input->src, tokens->input->src + start, tokens->s_src);
+  }
+
+  uint64_t riscv_tokens_retain(RISCVTokenStream* tokens, const RISCVTokenStream* from, const uint64_t i) {
+    error(FATAL, i >= from->s_tokens, "lexer - token index is outside of the stream: ", i, __FILE__, __LINE__);
+
+    // retained tokens are not a piece of the file, they have no line table and
+    // their offsets point into the stream's own copy of its string literals
+    if (tokens->s_tokens >= tokens->max_s_tokens)
+      _lexer_tokens_reserve(tokens, tokens->max_s_tokens << 1, 0);
+
+    error(FATAL, tokens->s_src > UINT32_MAX, "lexer - token offsets are 32 bit, retained string literals are larger than 4 GiB", "", __FILE__, __LINE__);
+    const uint64_t r = tokens->s_tokens++;
+    tokens->types[r]   = from->types[i];
+    tokens->lits[r]    = from->lits[i];
+    tokens->offsets[r] = (uint32_t)tokens->s_src;
+
+    if (from->types[i] == TOKEN_LIT_STRING) {
+      const char* str = riscv_tokens_get_source(from, i);
+      _lexer_tokens_source_push(tokens, str, (uint64_t)(_lexer_string_end(str) - str + 1));
+    }
+    return r;
+  }
+}
+
+void _lexer_window_drop(lexer::RISCVLexer* lexer) {
+  // drop what was lexed and keep the unfinished line at the front
+  const uint64_t s_left = lexer->s_window - lexer->cursor;
+  memmove(lexer->window, lexer->window + lexer->cursor, s_left);
+  lexer->offset  += lexer->cursor;
+  lexer->cursor   = 0;
+  lexer->s_window = s_left;
+  lexer->window[lexer->s_window] = CHAR_END;
+}
+
+void _lexer_window_fill(lexer::RISCVLexer* lexer) {
+  // the window holds the whole batch, a batch or a line longer than the window
+  // makes it grow, one byte is kept for the terminator
+  if (lexer->s_window + 1 >= lexer->max_s_window) {
+    lexer->max_s_window <<= 1;
+    lexer->window = (char*)realloc(lexer->window, lexer->max_s_window * sizeof(char));
+    error(FATAL, lexer->window == nullptr, "lexer - reallocation of input window returned a NULL pointer", "", __FILE__, __LINE__);
+    trace(TRACE_LEXER, "lexer - grew input window to ", lexer->max_s_window, __FILE__, __LINE__);
+  }
+
+  const ssize_t s_read = read(lexer->fd, lexer->window + lexer->s_window, lexer->max_s_window - lexer->s_window - 1);
+  error(FATAL, s_read < 0, "lexer - could not read input file ", lexer->filename, __FILE__, __LINE__);
+  lexer->eof       = s_read == 0;
+  lexer->s_window += (uint64_t)s_read;
+  lexer->window[lexer->s_window] = CHAR_END;
+}
+
+void _lexer_tokens_source_push(lexer::RISCVTokenStream* tokens, const char* src, const uint64_t s_src) {
+  if (tokens->input == nullptr) {
+    tokens->input = (LexerInput*)malloc(sizeof(LexerInput));
+    error(FATAL, tokens->input == nullptr, "lexer - allocation of input handle returned a NULL pointer", "", __FILE__, __LINE__);
+    *tokens->input = (LexerInput){ .src = nullptr, .s_src = 0, .mapped = false };
+    tokens->max_s_src = 0;
+  }
+
+  // one byte is kept for a terminator, the same as every other source buffer
+  if (tokens->s_src + s_src + 1 > tokens->max_s_src) {
+    tokens->max_s_src = (tokens->s_src + s_src + 1) << 1;
+    tokens->input->src   = (char*)realloc(tokens->input->src, tokens->max_s_src * sizeof(char));
+    tokens->input->s_src = tokens->max_s_src;
+    error(FATAL, tokens->input->src == nullptr, "lexer - reallocation of source copy returned a NULL pointer", "", __FILE__, __LINE__);
+  }
+
+  memcpy(tokens->input->src + tokens->s_src, src, s_src);
+  tokens->s_src += s_src;
+  tokens->input->src[tokens->s_src] = CHAR_END;
+  tokens->src = tokens->input->src;
+}
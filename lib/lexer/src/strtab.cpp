@@ -0,0 +1,159 @@
+#include "lexer_private.hpp"
+
+namespace lexer {
+  RISCVStrTab* riscv_strtab_create() {
+    RISCVStrTab* strtab = (RISCVStrTab*)malloc(sizeof(struct riscv_strtab));
+    error(FATAL, strtab == nullptr, "lexer - allocation of string table returned a NULL pointer", "", __FILE__, __LINE__);
+
+    *strtab = (RISCVStrTab){
+      .blocks        = nullptr,
+      .s_blocks      = 0,
+      .max_s_blocks  = 0,
+      .s_block       = STRTAB_S_BLOCK,
+      .entries       = nullptr,
+      .s_entries     = 0,
+      .max_s_entries = 1 << 6,
+      .slots         = nullptr,
+      .max_s_slots   = 1 << 7
+    };
+
+    strtab->entries = (struct riscv_strtab::riscv_strtab_entry*)malloc(strtab->max_s_entries * sizeof(struct riscv_strtab::riscv_strtab_entry));
+    error(FATAL, strtab->entries == nullptr, "lexer - allocation of string table entries returned a NULL pointer", "", __FILE__, __LINE__);
+    strtab->slots = (uint32_t*)calloc(strtab->max_s_slots, sizeof(uint32_t));
+    error(FATAL, strtab->slots == nullptr, "lexer - allocation of string table slots returned a NULL pointer", "", __FILE__, __LINE__);
+
+    return strtab;
+  }
+
+  uint32_t riscv_strtab_intern(RISCVStrTab* strtab, const char* str, const uint32_t s_str, const uint32_t hash) {
+    error(FATAL, strtab == nullptr, "lexer - string table is a NULL pointer", "", __FILE__, __LINE__);
+
+    uint32_t mask = strtab->max_s_slots - 1, slot = hash & mask;
+    for (; strtab->slots[slot] != 0; slot = (slot + 1) & mask) {
+      const struct riscv_strtab::riscv_strtab_entry* entry = &strtab->entries[strtab->slots[slot] - 1];
+      if (entry->hash == hash && entry->s_string == s_str && memcmp(entry->string, str, s_str) == 0)
+        return strtab->slots[slot] - 1;
+    }
+
+    if (strtab->s_entries >= strtab->max_s_entries) {
+      strtab->max_s_entries <<= 1;
+      strtab->entries = (struct riscv_strtab::riscv_strtab_entry*)realloc(
+        strtab->entries,
+        strtab->max_s_entries * sizeof(struct riscv_strtab::riscv_strtab_entry)
+      );
+      error(FATAL, strtab->entries == nullptr, "lexer - reallocation of string table entries returned a NULL pointer", "", __FILE__, __LINE__);
+    }
+
+    const uint32_t id = strtab->s_entries++;
+    strtab->entries[id] = (struct riscv_strtab::riscv_strtab_entry){
+      .string   = _lexer_strtab_arena_alloc(strtab, s_str + 1),
+      .s_string = s_str,
+      .hash     = hash
+    };
+    memcpy(strtab->entries[id].string, str, s_str);
+    strtab->entries[id].string[s_str] = CHAR_END;
+    strtab->slots[slot] = id + 1;
+    trace(TRACE_LEXER, "lexer - interned string ", strtab->entries[id].string, __FILE__, __LINE__);
+
+    // keep the load factor at or below one half
+    if (2 * strtab->s_entries > strtab->max_s_slots)
+      _lexer_strtab_slots_grow(strtab);
+
+    return id;
+  }
+
+  const char* riscv_strtab_get(const RISCVStrTab* strtab, const uint32_t id) {
+    error(FATAL, strtab == nullptr, "lexer - string table is a NULL pointer", "", __FILE__, __LINE__);
+    error(FATAL, id >= strtab->s_entries, "lexer - string id is outside of the string table: ", id, __FILE__, __LINE__);
+    return strtab->entries[id].string;
+  }
+
+  uint32_t riscv_strtab_get_size(const RISCVStrTab* strtab, const uint32_t id) {
+    error(FATAL, strtab == nullptr, "lexer - string table is a NULL pointer", "", __FILE__, __LINE__);
+    error(FATAL, id >= strtab->s_entries, "lexer - string id is outside of the string table: ", id, __FILE__, __LINE__);
+    return strtab->entries[id].s_string;
+  }
+
+  void riscv_strtab_borrow(RISCVStrTab* strtab, const struct riscv_strtab::riscv_strtab_entry* entries, const uint32_t s_entries) {
+    error(FATAL, strtab == nullptr, "lexer - string table is a NULL pointer", "", __FILE__, __LINE__);
+
+    // the strings stay in the arena of the table they come from, which has to
+    // outlive this one; nothing is hashed, a table that borrows is only read
+    if (s_entries == 0)
+      return;
+    if (strtab->s_entries + s_entries > strtab->max_s_entries) {
+      strtab->max_s_entries = (strtab->s_entries + s_entries) << 1;
+      strtab->entries = (struct riscv_strtab::riscv_strtab_entry*)realloc(
+        strtab->entries,
+        strtab->max_s_entries * sizeof(struct riscv_strtab::riscv_strtab_entry)
+      );
+      error(FATAL, strtab->entries == nullptr, "lexer - reallocation of string table entries returned a NULL pointer", "", __FILE__, __LINE__);
+    }
+    memcpy(strtab->entries + strtab->s_entries, entries, s_entries * sizeof(struct riscv_strtab::riscv_strtab_entry));
+    strtab->s_entries += s_entries;
+  }
+
+  void riscv_strtab_free(RISCVStrTab* strtab) {
+    if (strtab == nullptr)
+      return;
+    for (uint32_t i = 0; i < strtab->s_blocks; i++)
+      free(strtab->blocks[i]);
+    free(strtab->blocks);
+    free(strtab->entries);
+    free(strtab->slots);
+    free(strtab);
+  }
+}
+
+char* _lexer_strtab_arena_alloc(lexer::RISCVStrTab* strtab, const uint32_t s_alloc) {
+  // oversized strings get a block of their own, slid under the current block
+  // so that it keeps serving the small ones
+  if (s_alloc > STRTAB_S_BLOCK / 4) {
+    _lexer_strtab_blocks_push(strtab, s_alloc);
+    char* alloc = strtab->blocks[strtab->s_blocks - 1];
+    if (strtab->s_blocks > 1) {
+      strtab->blocks[strtab->s_blocks - 1] = strtab->blocks[strtab->s_blocks - 2];
+      strtab->blocks[strtab->s_blocks - 2] = alloc;
+    }
+    return alloc;
+  }
+
+  if (strtab->s_block + s_alloc > STRTAB_S_BLOCK) {
+    _lexer_strtab_blocks_push(strtab, STRTAB_S_BLOCK);
+    strtab->s_block = 0;
+  }
+
+  char* alloc = strtab->blocks[strtab->s_blocks - 1] + strtab->s_block;
+  strtab->s_block += s_alloc;
+  return alloc;
+}
+
+void _lexer_strtab_blocks_push(lexer::RISCVStrTab* strtab, const uint32_t s_alloc) {
+  if (strtab->s_blocks >= strtab->max_s_blocks) {
+    strtab->max_s_blocks = strtab->max_s_blocks ? strtab->max_s_blocks << 1 : 1 << 3;
+    strtab->blocks = (char**)realloc(strtab->blocks, strtab->max_s_blocks * sizeof(char*));
+    error(FATAL, strtab->blocks == nullptr, "lexer - reallocation of string arena returned a NULL pointer", "", __FILE__, __LINE__);
+  }
+
+  char* block = (char*)malloc(s_alloc * sizeof(char));
+  error(FATAL, block == nullptr, "lexer - allocation of string arena block returned a NULL pointer", "", __FILE__, __LINE__);
+  strtab->blocks[strtab->s_blocks++] = block;
+}
+
+void _lexer_strtab_slots_grow(lexer::RISCVStrTab* strtab) {
+  const uint32_t max_s_slots = strtab->max_s_slots << 1, mask = max_s_slots - 1;
+  uint32_t* slots = (uint32_t*)calloc(max_s_slots, sizeof(uint32_t));
+  error(FATAL, slots == nullptr, "lexer - reallocation of string table slots returned a NULL pointer", "", __FILE__, __LINE__);
+
+  // the cached hashes make rehashing a pass over the entries, no string is touched
+  for (uint32_t id = 0; id < strtab->s_entries; id++) {
+    uint32_t slot = strtab->entries[id].hash & mask;
+    while (slots[slot] != 0)
+      slot = (slot + 1) & mask;
+    slots[slot] = id + 1;
+  }
+
+  free(strtab->slots);
+  strtab->slots       = slots;
+  strtab->max_s_slots = max_s_slots;
+}
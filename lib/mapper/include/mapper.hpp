@@ -1,22 +1,66 @@
 #ifndef __MAPPER_H__
 #define __MAPPER_H__
 
-#include <unordered_map>
+#include <vector>
 
 #include "parser.hpp"
 
+// regions a layout can describe, names are NUL terminated
+#define MAPPER_MAX_S_REGIONS 8
+#define MAPPER_S_REGION_NAME 16
+
+// one region from the start of RAM to the top of the address space, each
+// section right after the one before it, the stack 16 byte aligned
+#define MAPPER_LAYOUT_DEFAULT \
+  "region ram 0x80000000 0x80000000; text ram; data ram; stack ram 4K align 16"
+
 namespace mapper {
   typedef struct riscv_encoding RISCVEncoding;
+  typedef struct riscv_region   RISCVRegion;
+  typedef struct riscv_section  RISCVSection;
+  typedef struct riscv_layout   RISCVLayout;
+
+  uint32_t  map_text_size    (const parser::RISCVIR*, uint8_t*);
+  uint32_t  map_data_size    (const parser::RISCVAST*);
+  bool      map_layout_parse (const char*, const char*, RISCVLayout&);
+  bool      map_layout_load  (const char*, RISCVLayout&);
+  bool      map_layout       (const RISCVLayout&, RISCVEncoding&);
+  void      map_inst2bin     (const parser::RISCVIR*, const uint8_t*, uint32_t*, const uint32_t, const uint32_t, const uint32_t);
+  void      map_data2bin     (const parser::RISCVAST*, uint32_t*);
+  void      map_output       (const char*, RISCVEncoding&);
+  void      unmap_output     (RISCVEncoding&);
+  void      map_disassemble  (const char*);
+
+  // a memory region of the target, length is in bytes and origin + length
+  // never goes past the 32 bit address space
+  struct riscv_region {
+    char     name[MAPPER_S_REGION_NAME];
+    uint32_t origin;
+    uint64_t length;
+  };
+
+  // where a section goes, region indexes regions and align is a power of two
+  struct riscv_section {
+    uint32_t region, align;
+  };
 
-  uint32_t* map_inst2bin (const parser::RISCVAST*, uint32_t&, const uint32_t, uint32_t&, uint32_t&, const uint32_t);
-  uint32_t* map_data2bin (const parser::RISCVAST*, uint32_t&);
-  void      write        (const char*, const RISCVEncoding&);
+  // sections sharing a region are packed into it in the order text, data,
+  // stack, each start rounded up to its own alignment and nothing else
+  struct riscv_layout {
+    RISCVRegion  regions[MAPPER_MAX_S_REGIONS];
+    uint32_t     s_regions;
+    RISCVSection text, data, stack;
+    uint32_t     s_stack; // in words
+  };
 
+  // map_output maps the output file for s_insts and s_data words, insts and
+  // data point into it and unmap_output writes the header in front of them
   struct riscv_encoding {
     uint32_t
       s_insts, s_data, s_stack,
       text_addr, data_addr, stack_addr,
-      *insts, *data;
+      *insts, *data, *file;
+    uint64_t s_file; // in bytes
   };
 }
 
@@ -1,184 +1,158 @@
 #ifndef __MAPPER_PRIVATE_H__
 #define __MAPPER_PRIVATE_H__
 
-#include "mapper.hpp"
-
-typedef enum optype {
-  OPTYPE_NONE,
-  OPTYPE_R,
-  OPTYPE_I,
-  OPTYPE_S,
-  OPTYPE_B,
-  OPTYPE_U,
-  OPTYPE_J
-} OpType;
-
-#define OPCODE_LUI     0b0110111
-#define OPCODE_AUIPC   0b0010111
-
-#define OPCODE_ADD     0b0110011
-#define OPCODE_ADDI    0b0010011
-#define OPCODE_SUB     0b0110011
-
-#define OPCODE_AND     0b0110011 
-#define FUNCT3_AND     0x7
-#define FUNCT7_AND     0x00
-
-#define OPCODE_ANDI    0b0010011 
-#define FUNCT3_ANDI    0x7
-
-#define OPCODE_OR      0b0110011
-#define FUNCT3_OR      0x6
-#define FUNCT7_OR      0x00
-
-#define OPCODE_ORI     0b0010011 
-#define FUNCT3_ORI     0x6
-
-#define OPCODE_XOR     0b0110011
-#define FUNCT3_XOR     0x4
-#define FUNCT7_XOR     0x00
-
-#define OPCODE_XORI    0b0010011 
-#define FUNCT3_XORI    0x4
-
-#define OPCODE_SLL     0b0110011
-#define FUNCT3_SLL     0x1
-#define FUNCT7_SLL     0x00
-
-#define OPCODE_SLLI    0b0010011 
-#define FUNCT3_SLLI    0x1
-
-#define OPCODE_SRL     0b0110011
-#define FUNCT3_SRL     0x5
-#define FUNCT7_SRL     0x00
-
-#define OPCODE_SRLI    0b0010011 
-#define FUNCT3_SRLI    0x5
-
-#define OPCODE_SRA     0b0110011
-#define FUNCT3_SRA     0x5
-#define FUNCT7_SRA     0x20
-
-#define OPCODE_SRAI    0b0010011 
-#define FUNCT3_SRAI    0x5
-
-#define OPCODE_MUL     0b0110011
-#define FUNCT3_MUL     0x1
-#define FUNCT7_MUL     0x01
-
-#define OPCODE_MULH    0b0110011
-#define FUNCT3_MULH    0x1
-#define FUNCT7_MULH    0x01
-
-#define OPCODE_MULSU   0b0110011
-#define FUNCT3_MULSU   0x2
-#define FUNCT7_MULSU   0x01
-
-#define OPCODE_MULU    0b0110011
-#define FUNCT3_MULU    0x3
-#define FUNCT7_MULU    0x01
-
-#define OPCODE_DIV     0b0110011
-#define FUNCT3_DIV     0x4
-#define FUNCT7_DIV     0x01
-
-#define OPCODE_DIVU    0b0110011
-#define FUNCT3_DIVU    0x5
-#define FUNCT7_DIVU    0x01
-
-#define OPCODE_REM     0b0110011
-#define FUNCT3_REM     0x6
-#define FUNCT7_REM     0x01
-
-#define OPCODE_REMU    0b0110011
-#define FUNCT3_REMU    0x7
-#define FUNCT7_REMU    0x01
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
-#define OPCODE_LB      0b0000011 
-#define FUNCT3_LB      0x0
-
-#define OPCODE_LH      0b0000011 
-#define FUNCT3_LH      0x1
-
-#define OPCODE_LW      0b0000011 
-#define FUNCT3_LW      0x2
-
-#define OPCODE_LBU     0b0000011 
-#define FUNCT3_LBU     0x2
-
-#define OPCODE_LHU     0b0000011 
-#define FUNCT3_LHU     0x2
-
-#define OPCODE_SB      0b0100011 
-#define FUNCT3_SB      0x0
-
-#define OPCODE_SH      0b0100011 
-#define FUNCT3_SH      0x1
-
-#define OPCODE_SW      0b0100011 
-#define FUNCT3_SW      0x2
-
-#define OPCODE_SLT     0b0110011
-#define FUNCT3_SLT     0x2
-#define FUNCT7_SLT     0x00
-
-#define OPCODE_SLTI    0b0010011 
-#define FUNCT3_SLTI    0x2
-
-#define OPCODE_SLTU    0b0110011
-#define FUNCT3_SLTU    0x3
-#define FUNCT7_SLTU    0x00
-
-#define OPCODE_SLTIU   0b0010011 
-#define FUNCT3_SLTIU   0x3
-
-#define OPCODE_BEQ     0b1100011 
-#define FUNCT3_BEQ     0x0
- 
-#define OPCODE_BNE     0b1100011 
-#define FUNCT3_BNE     0x1
-
-#define OPCODE_BGE     0b1100011 
-#define FUNCT3_BGE     0x5
-
-#define OPCODE_BLT     0b1100011 
-#define FUNCT3_BLT     0x4
-
-#define OPCODE_BGEU    0b1100011 
-#define FUNCT3_BGEU    0x7
- 
-#define OPCODE_BLTU    0b1100011 
-#define FUNCT3_BLTU    0x6
-
-#define OPCODE_JAL     0b1101111
-
-#define OPCODE_JALR    0b1100111
-#define FUNCT3_JALR    0x0
-
-#define OPCODE_OS      0b1110011
-#define IMM_ECALL      0x0
-#define IMM_EBREAK     0x1
-#define IMM_SRET       0x102
-
-#define OPCODE_LNS_ADD 0b0000000
-#define FUNCT3_LNS_ADD 0x0
-#define FUNCT7_LNS_ADD 0x00
-
-#define OPCODE_LNS_SUB 0b0000000
-#define FUNCT3_LNS_SUB 0x0
-#define FUNCT7_LNS_SUB 0x00
-
-#define OPCODE_LNS_MUL 0b0000000
-#define FUNCT3_LNS_MUL 0x0
-#define FUNCT7_LNS_MUL 0x00
-
-#define OPCODE_LNS_DIV 0b0000000
-#define FUNCT3_LNS_DIV 0x0
-#define FUNCT7_LNS_DIV 0x00
+#include "mapper.hpp"
 
-#define OPCODE_LNS_SQT 0b0000000
-#define FUNCT3_LNS_SQT 0x0
-#define FUNCT7_LNS_SQT 0x00
+// SSE2 is part of x86-64, so the data packer needs no runtime dispatch
+#if defined(__SSE2__)
+#define MAPPER_DATA_SSE2 1
+#include <emmintrin.h>
+#else
+#define MAPPER_DATA_SSE2 0
+#endif
+
+// words in front of the text section in the output file
+#define MAPPER_S_HEADER 6
+
+#define MAPPER_MIN_S_CHUNK (1 << 16) // instructions, a thread is not worth it for fewer
+
+// layout statements are a handful of words, separated by ';' or a newline
+#define MAPPER_LAYOUT_MAX_S_WORDS 6
+#define MAPPER_LAYOUT_MAX_S_NUMBER 24 // digits and suffix of a number word
+#define MAPPER_REGION_NONE UINT32_MAX
+#define MAPPER_ALIGN_WORD  4 // what a section starts on when it names no alignment
+
+typedef struct mapper_layout_word {
+  const char* str;
+  uint32_t    s_str;
+} MapperLayoutWord;
+
+// a run of the lowered program that one thread encodes, at is the word its
+// first instruction goes to
+typedef struct mapper_chunk {
+  uint64_t begin, end;
+  uint64_t at;
+} MapperChunk;
+
+// addresses are word aligned, so this is never one
+#define MAPPER_ADDR_NONE UINT32_MAX
+
+#define REG_X0         0
+#define REG_X1         1
+
+// a row of RISCV_ISA as the mapper uses it, indexed by token type; match and
+// mask are the bits a base instruction fixes in its word, which is all the
+// decoder looks at
+typedef struct mapper_isa_inst {
+  const char* mnemonic;
+  uint8_t     kind, format, opcode, funct3, funct7;
+  uint8_t     rd, rs1, rs2; // ISA_REG_* sources of the register fields
+  int32_t     imm;          // ISA_IMM or the constant the immediate is fixed to
+  uint32_t    match, mask;
+} MapperIsaInst;
+
+typedef struct mapper_isa_table {
+  MapperIsaInst insts[lexer::TOKEN_INST_32IM_MAX];
+} MapperIsaTable;
+
+constexpr uint32_t riscv_map_isa_reg(const uint8_t source) {
+  return source == ISA_REG_X0 ? REG_X0 : REG_X1;
+}
+
+constexpr bool riscv_map_isa_reg_fixed(const uint8_t source) {
+  return source == ISA_REG_X0 || source == ISA_REG_RA;
+}
+
+constexpr MapperIsaInst riscv_map_isa_inst(
+  const char* mnemonic, const uint8_t kind, const uint8_t format,
+  const uint8_t opcode, const uint8_t funct3, const uint8_t funct7,
+  const uint8_t rd, const uint8_t rs1, const uint8_t rs2, const int32_t imm
+) {
+  MapperIsaInst inst = { mnemonic, kind, format, opcode, funct3, funct7, rd, rs1, rs2, imm, opcode, 0x7F };
+
+  if (format != ISA_FORMAT_U && format != ISA_FORMAT_J) {
+    inst.match |= (uint32_t)funct3 << 12;
+    inst.mask  |= 0x7u << 12;
+  }
+  if (format == ISA_FORMAT_R || format == ISA_FORMAT_SHIFT) {
+    inst.match |= (uint32_t)funct7 << 25;
+    inst.mask  |= 0x7Fu << 25;
+  }
+  if (format == ISA_FORMAT_I && imm != ISA_IMM) {
+    inst.match |= ((uint32_t)imm & 0xFFF) << 20;
+    inst.mask  |= 0xFFFu << 20;
+  }
+
+  // registers a row fixes, ecall is told apart from ebreak by them and imm
+  const uint8_t sources[3] = { rd, rs1, rs2 };
+  const uint32_t shifts[3] = { 7, 15, 20 };
+  for (uint32_t k = 0; k < 3; k++) {
+    if (riscv_map_isa_reg_fixed(sources[k])) {
+      inst.match |= riscv_map_isa_reg(sources[k]) << shifts[k];
+      inst.mask  |= 0x1Fu << shifts[k];
+    }
+  }
+  return inst;
+}
+
+constexpr MapperIsaTable riscv_map_isa_build() {
+  MapperIsaTable table = {};
+#define MAPPER_ISA_INST(type, mnemonic, kind, format, opcode, funct3, funct7, rd, rs1, rs2, imm) \
+  table.insts[lexer::type] = riscv_map_isa_inst(                                                \
+    mnemonic, ISA_KIND_##kind, ISA_FORMAT_##format, ISA_OPCODE_##opcode, funct3, funct7,        \
+    ISA_REG_##rd, ISA_REG_##rs1, ISA_REG_##rs2, imm                                             \
+  );
+  RISCV_ISA(MAPPER_ISA_INST)
+#undef MAPPER_ISA_INST
+  return table;
+}
+
+inline constexpr MapperIsaTable MAPPER_ISA = riscv_map_isa_build();
+
+// no word may decode to two base instructions, two rows that agree on every
+// bit both of them fix would
+constexpr bool riscv_map_isa_unique() {
+  for (uint32_t a = lexer::TOKEN_INST_32IM_NOP; a < lexer::TOKEN_INST_32IM_MAX; a++) {
+    for (uint32_t b = a + 1; b < lexer::TOKEN_INST_32IM_MAX; b++) {
+      const MapperIsaInst &x = MAPPER_ISA.insts[a], &y = MAPPER_ISA.insts[b];
+      if (x.kind == ISA_KIND_BASE && y.kind == ISA_KIND_BASE && ((x.match ^ y.match) & x.mask & y.mask) == 0)
+        return false;
+    }
+  }
+  return true;
+}
+
+// an alias has to be spelled like one of the base instructions
+constexpr bool riscv_map_isa_aliases() {
+  for (uint32_t a = lexer::TOKEN_INST_32IM_NOP; a < lexer::TOKEN_INST_32IM_MAX; a++) {
+    const MapperIsaInst& x = MAPPER_ISA.insts[a];
+    if (x.kind != ISA_KIND_ALIAS)
+      continue;
+
+    bool found = false;
+    for (uint32_t b = lexer::TOKEN_INST_32IM_NOP; b < lexer::TOKEN_INST_32IM_MAX && !found; b++) {
+      const MapperIsaInst& y = MAPPER_ISA.insts[b];
+      found =
+        y.kind == ISA_KIND_BASE && y.format == x.format && y.opcode == x.opcode &&
+        y.funct3 == x.funct3 && y.funct7 == x.funct7;
+    }
+    if (!found)
+      return false;
+  }
+  return true;
+}
+
+static_assert(riscv_map_isa_unique(), "mapper - two base instructions in RISCV_ISA share an encoding");
+static_assert(riscv_map_isa_aliases(), "mapper - an alias in RISCV_ISA does not encode as any base instruction");
+static_assert(
+  ISA_REG_NONE == 0 && ISA_REG_RD == 1 && ISA_REG_RS1 == 2 && ISA_REG_RS2 == 3 &&
+  ISA_REG_X0 == 4 && ISA_REG_RA == 5 && ISA_REG_RD_RA == 6,
+  "mapper - riscv_map_pack looks register sources up by their ISA_REG_* value"
+);
 
 inline uint32_t riscv_map_r_type (const uint8_t, const uint8_t, const uint8_t, const uint8_t, const uint8_t, const uint8_t);
 inline uint32_t riscv_map_i_type (const uint16_t, const uint8_t, const uint8_t, const uint8_t, const uint8_t);
@@ -187,7 +161,33 @@ inline uint32_t riscv_map_b_type (const uint16_t, const uint8_t, const uint8_t,
 inline uint32_t riscv_map_u_type (const uint32_t, const uint8_t, const uint8_t);
 inline uint32_t riscv_map_j_type (const uint32_t, const uint8_t, const uint8_t);
 
+void            riscv_map_chunk         (const MapperChunk*, const parser::RISCVIR*, const uint8_t*, const std::vector<uint32_t>&, const uint32_t, uint32_t*);
+uint32_t        riscv_map_inst_size     (const parser::RISCVIR_Inst*);
+uint32_t        riscv_map_inst          (const parser::RISCVIR_Inst*, const uint32_t, const uint32_t, const std::vector<uint32_t>&, uint32_t*);
+uint32_t        riscv_map_expand        (const MapperIsaInst*, const parser::RISCVIR_Inst*, const uint32_t, const std::vector<uint32_t>&, uint32_t*);
+uint32_t        riscv_map_li            (const int32_t, const uint8_t, uint32_t*);
+uint32_t        riscv_map_relax         (const MapperIsaInst*, const parser::RISCVIR_Inst*, const uint32_t, const std::vector<uint32_t>&, uint32_t*);
+inline bool     riscv_map_is_branch     (const parser::RISCVIR_Inst*);
+void            riscv_map_label_offsets (const parser::RISCVIR*, const uint8_t*, std::vector<uint32_t>&);
+inline bool     riscv_map_fits_branch   (const int64_t);
+inline bool     riscv_map_fits_jump     (const int64_t);
+inline bool     riscv_map_is_expanded   (const MapperIsaInst*, const parser::RISCVIR_Inst*);
+inline uint32_t riscv_map_pack          (const MapperIsaInst*, const parser::RISCVIR_Inst*, const uint32_t, const std::vector<uint32_t>&);
+bool            riscv_map_decode        (const uint32_t, parser::RISCVIR_Inst&);
+void            riscv_map_print_inst    (const parser::RISCVIR_Inst*, const uint32_t);
+inline uint32_t riscv_map_symbol_addr   (const std::vector<uint32_t>&, const uint32_t);
 inline uint32_t riscv_map_relative_addr (const uint32_t, const uint32_t);
-inline uint32_t next_pow2               (uint32_t x);
+inline int32_t  riscv_map_sign_extend   (const uint32_t, const uint32_t);
+uint32_t        riscv_map_data_size     (const uint32_t);
+uint32_t        riscv_map_data_strings  (const lexer::RISCVTokenStream*, const parser::RISCVASTN_Data*, uint8_t*);
+uint32_t        riscv_map_data_numbers  (const lexer::RISCVTokenStream*, const parser::RISCVASTN_Data*, const uint64_t, uint8_t*);
+#if MAPPER_DATA_SSE2
+inline __m128i  riscv_map_sse2_evens    (const lexer::RISCVTokenLit*);
+#endif
+bool            riscv_map_layout_stmt   (const MapperLayoutWord*, const uint32_t, mapper::RISCVLayout&, const char*, const uint32_t);
+bool            riscv_map_layout_sect   (const MapperLayoutWord*, const uint32_t, const uint32_t, mapper::RISCVLayout&, mapper::RISCVSection&, const char*, const uint32_t);
+uint32_t        riscv_map_layout_region (const mapper::RISCVLayout&, const MapperLayoutWord&);
+bool            riscv_map_layout_number (const MapperLayoutWord&, uint64_t&);
+inline bool     riscv_map_layout_is     (const MapperLayoutWord&, const char*);
 
 #endif // !__MAPPER_PRIVATE_H__
@@ -1,1172 +1,566 @@
+#include <thread>
+
 #include "mapper_private.hpp"
 
 namespace mapper {
-  uint32_t* map_inst2bin(
-    const parser::RISCVAST* ast, uint32_t& s_insts,
-    const uint32_t text_addr, uint32_t& data_addr,
-    uint32_t& stack_addr, const uint32_t s_stack
-  ) {
-    error(FATAL, ast == nullptr, "mapper - ast is a nullptr in map_inst2bin", "", __FILE__, __LINE__);
-
-    // using this instead of std::string in the unordered_map
-    // in order to save memory
-    auto cstr_hash = [](const char* str) { 
-      std::size_t hash = 0;
-      while (*str) {
-        hash = hash * 31 + *str++;
-      }
-      return hash;
-    };
-
-    auto cstr_equal = [](const char* a, const char* b) { 
-      return std::strcmp(a, b) == 0; 
-    };
-
-    std::unordered_map<const char*, uint32_t, decltype(cstr_hash), decltype(cstr_equal)> map(
-      0,
-      cstr_hash,
-      cstr_equal
-    );
-
-    uint32_t text_cursor = text_addr;
-    for (uint64_t i = 0; i < ast->s_text; i++) {
-      const parser::RISCVASTN_Text* inst = &(ast->text[i]);
-      const lexer::RISCVTokenType type = ast->text[i].inst->type;
-
-      if (!lexer::riscv_token_is_symbol(type)) {
-        text_cursor += 4;
+  uint32_t map_text_size(const parser::RISCVIR* ir, uint8_t* sizes) {
+    error(FATAL, ir == nullptr, "mapper - ir is a nullptr in ", __FUNCTION__, __FILE__, __LINE__);
+
+    // every branch starts out as a single word, anything else has the size
+    // it will always have
+    uint64_t s_insts = 0, s_branches = 0;
+    for (uint64_t i = 0; i < ir->s_insts; i++) {
+      sizes[i] = riscv_map_inst_size(&ir->insts[i]);
+      s_insts += sizes[i];
+      s_branches += riscv_map_is_branch(&ir->insts[i]);
+    }
 
-        switch (type) {
-          case lexer::TOKEN_INST_32IM_MOVE_LI: {
-            text_cursor += (inst->f2->lit.number > 0x00000FFF) * 4; // lower bound for load immediate needs one more inst
-            break;
-          }
-          case lexer::TOKEN_INST_32IM_LS_LB:
-          case lexer::TOKEN_INST_32IM_LS_LH:
-          case lexer::TOKEN_INST_32IM_LS_LW: {
-            text_cursor += lexer::riscv_token_is_symbol(inst->f2->type) * 4;
-            break;
+    // a branch that cannot reach its label becomes an inverted branch over
+    // a jal, which moves every label after it and can push other branches
+    // out of range; sizes only grow, so repeating until none changes ends
+    std::vector<uint32_t> offsets(s_branches > 0 ? ir->s_symbols : 0);
+    for (uint64_t relaxed = s_branches; relaxed > 0; ) {
+      relaxed = 0;
+      riscv_map_label_offsets(ir, sizes, offsets);
+
+      uint64_t at = 0;
+      for (uint64_t i = 0; i < ir->s_insts; i++) {
+        if (sizes[i] == 1 && riscv_map_is_branch(&ir->insts[i]) && offsets[ir->insts[i].symbol] != MAPPER_ADDR_NONE) {
+          const int64_t offset = (int64_t)offsets[ir->insts[i].symbol] - (int64_t)(at << 2);
+          if (!riscv_map_fits_branch(offset)) {
+            sizes[i] = 2;
+            s_insts++;
+            relaxed++;
           }
-          case lexer::TOKEN_INST_32IM_MOVE_LA:
-          case lexer::TOKEN_INST_32IM_FC_CALL: {
-            text_cursor += 4;
-            break;
-          }
-          default: { break; }
         }
-
-        continue;
+        at += sizes[i];
       }
-
-      map.insert({ ast->text[i].inst->lit.string, text_cursor });
+      trace(TRACE_MAPPER, "mapper - relaxed branches: ", relaxed, __FILE__, __LINE__);
     }
 
-     /* text_cursor ends at the first byte AFTER .text */
-    const uint32_t 
-      text_size = text_cursor - text_addr,
-      aligned_text_size = next_pow2(text_size),
-      data_base = text_addr + aligned_text_size;
-    data_addr = data_base;
-
-    uint32_t data_cursor = data_base;
-    for (uint64_t i = 0; i < ast->s_data; i++) {
-      map.insert({ ast->data[i].symbol->lit.string, data_cursor });
+    error(FATAL, s_insts > UINT32_MAX >> 2, "mapper - text section does not fit the 32 bit address space in ", __FUNCTION__, __FILE__, __LINE__);
+    return (uint32_t)s_insts;
+  }
 
-      if (ast->data[i].type->type != lexer::TOKEN_STRING) {
-        data_cursor += lexer::riscv_token_get_type_size(ast->data[i].type->type) * ast->data[i].s_arr;
-        continue;
+  void map_inst2bin(
+    const parser::RISCVIR* ir, const uint8_t* sizes, uint32_t* insts,
+    const uint32_t text_addr, const uint32_t data_addr, const uint32_t s_threads
+  ) {
+    error(FATAL, ir == nullptr, "mapper - ir is a nullptr in map_inst2bin", "", __FILE__, __LINE__);
+    error(FATAL, s_threads == 0, "mapper - encoding needs at least one thread", "", __FILE__, __LINE__);
+
+    // symbol ids are dense, an address is a single load away; the first
+    // definition of a symbol is the one that counts
+    std::vector<uint32_t> addrs(ir->s_symbols, MAPPER_ADDR_NONE);
+
+    uint64_t s_chunks = ir->s_insts / MAPPER_MIN_S_CHUNK;
+    s_chunks = s_chunks < 1 ? 1 : (s_chunks > s_threads ? s_threads : s_chunks);
+    MapperChunk* chunks = (MapperChunk*)malloc(s_chunks * sizeof(MapperChunk));
+    error(FATAL, chunks == nullptr, "mapper - allocation of encoding chunks returned a nullptr", "", __FILE__, __LINE__);
+
+    // the layout is a prefix sum over the sizes, it places every label before
+    // anything is encoded and gives every chunk the word it starts on
+    uint64_t s_insts = 0;
+    for (uint64_t c = 0; c < s_chunks; c++) {
+      chunks[c] = (MapperChunk){
+        .begin = ir->s_insts * c / s_chunks,
+        .end   = ir->s_insts * (c + 1) / s_chunks,
+        .at    = s_insts
+      };
+      for (uint64_t i = chunks[c].begin; i < chunks[c].end; i++) {
+        if (ir->insts[i].op == IR_OP_LABEL && addrs[ir->insts[i].symbol] == MAPPER_ADDR_NONE)
+          addrs[ir->insts[i].symbol] = text_addr + (uint32_t)(s_insts << 2);
+        s_insts += sizes[i];
       }
-
-      for (uint64_t j = 0; j < ast->data[i].s_arr; j++)
-        data_cursor += strlen(ast->data[i].arr[j]->lit.string) + 1;
     }
 
-    const uint32_t 
-      data_size = data_cursor - data_base,
-      aligned_data_size = next_pow2(data_size),
-      stack_base = data_base + aligned_data_size;
-    stack_addr = stack_base + s_stack; // this is the top of the stack, so it grows downward
+    // data symbols follow map_data2bin, which starts every directive on a word
+    uint32_t data_cursor = data_addr;
+    for (uint64_t i = 0; i < ir->s_data; i++) {
+      if (addrs[ir->data[i].symbol] == MAPPER_ADDR_NONE)
+        addrs[ir->data[i].symbol] = data_cursor;
+      data_cursor += riscv_map_data_size(ir->data[i].size);
+    }
 
     /*
      * used for debug
-      for (const auto& [label, addr] : map)
-        std::cout << "Label: " << label << " -> 0x" << std::hex << addr << std::endl;
+      for (uint32_t symbol = 0; symbol < ir->s_symbols; symbol++)
+        std::cout << "Label: " << symbol << " -> 0x" << std::hex << addrs[symbol] << std::endl;
      * */
- 
-    uint64_t max_s_insts = ast->s_text >= 4 ? ast->s_text : 4;
-    uint32_t* insts = (uint32_t*)malloc(max_s_insts * sizeof(uint32_t));
-    error(FATAL, insts == nullptr, "mapper - allocation of instruction array returned a nullptr", "", __FILE__, __LINE__);
-
-    for (uint64_t i = 0; i < ast->s_text; i++) {
-      if (s_insts + 1 >= max_s_insts) { // In case we get a pseudo instruction that needs 2 instructions
-        max_s_insts += max_s_insts >> 2;
-        insts = (uint32_t*)realloc(insts, max_s_insts * sizeof(uint32_t));
-        error(FATAL, insts == nullptr, "mapper - reallocation of instruction array returned a nullptr", "", __FILE__, __LINE__);
-      }
-      const uint32_t pc = text_addr + (s_insts << 2);
-
-      const parser::RISCVASTN_Text* inst = &(ast->text[i]);
-
-      if (lexer::riscv_token_is_symbol(inst->inst->type))
-        continue;
-
-      OpType optype = OPTYPE_NONE;
-      uint8_t 
-        opcode = 0x00,
-        funct3 = 0x0,
-        funct7 = 0x00;
-
-      switch (inst->inst->type) {
-        case lexer::TOKEN_INST_32IM_NOP: {
-          insts[s_insts++] = riscv_map_i_type(
-            0x0,
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            0x0,
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_ADDI
-          );
-          continue;
-        }
-
-        case lexer::TOKEN_INST_32IM_MOVE_LA: {
-          const uint32_t target_addr = map[inst->f2->lit.string];
-          const int32_t offset = (int32_t)riscv_map_relative_addr(pc, target_addr);
-          
-          /*
-           * used for debug
-          std::cout << "LA: pc=0x" << std::hex << pc 
-                    << " target=0x" << target_addr 
-                    << " offset=" << std::dec << offset << std::endl;
-           * */
-                    
-          // Split with proper sign handling
-          int32_t
-            upper = offset & 0xFFFFF000,
-            lower = offset & 0xFFF;
-          
-          // If lower will be sign-extended as negative by addi, compensate upper
-          if (lower & 0x800)
-            upper += 0x1000;
-          
-          insts[s_insts++] = riscv_map_u_type(
-            upper,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_AUIPC
-          );
-          insts[s_insts++] = riscv_map_i_type(
-            lower,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            0x0,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_ADDI
-          );
-          continue;
-        }
-
-        case lexer::TOKEN_INST_32IM_MOVE_LI: {
-          insts[s_insts++] = riscv_map_i_type(
-            inst->f2->lit.number,
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            0x0,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_ADDI
-          );
-          if (inst->f2->lit.number <= 0x00000FFF) // lower bound for load immediate
-            continue;
-
-          insts[s_insts++] = riscv_map_u_type(
-            inst->f2->lit.number,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_LUI
-          );
-          continue;
-        }
-
-        case lexer::TOKEN_INST_32IM_MOVE_LUI: {
-          optype = OPTYPE_U;
-          opcode = OPCODE_LUI;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_MOVE_AUIPC: {
-          optype = OPTYPE_U;
-          opcode = OPCODE_AUIPC;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_MOVE_MV: {
-          insts[s_insts++] = riscv_map_i_type(
-            0x0,
-            lexer::riscv_token_get_reg(inst->f2->type, __FUNCTION__, __FILE__, __LINE__),
-            0x0,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_ADDI
-          );
-          continue;
-        }
-
-        case lexer::TOKEN_INST_32IM_ALS_NEG: {
-          insts[s_insts++] = riscv_map_r_type(
-            0x20,
-            lexer::riscv_token_get_reg(inst->f2->type, __FUNCTION__, __FILE__, __LINE__),
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            0x0,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_SUB
-          );
-          continue;
-        }
-
-        case lexer::TOKEN_INST_32IM_ALS_ADD: {
-          optype = OPTYPE_R;
-          opcode = OPCODE_ADD;
-          funct3 = 0x0;
-          funct7 = 0x00;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_ALS_ADDI: {
-          optype = OPTYPE_I;
-          opcode = OPCODE_ADDI;
-          funct3 = 0x0;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_ALS_SUB: {
-          optype = OPTYPE_R;
-          opcode = OPCODE_SUB;
-          funct3 = 0x0;
-          funct7 = 0x20;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_ALS_NOT: {
-          insts[s_insts++] = riscv_map_i_type(
-            0xFFF,
-            lexer::riscv_token_get_reg(inst->f2->type, __FUNCTION__, __FILE__, __LINE__),
-            0x4,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_XORI
-          );
-          continue;
-        }
-
-        case lexer::TOKEN_INST_32IM_ALS_AND: {
-          optype = OPTYPE_R;
-          opcode = OPCODE_AND;
-          funct3 = FUNCT3_AND;
-          funct7 = FUNCT7_AND;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_ALS_ANDI: {
-          optype = OPTYPE_I;
-          opcode = OPCODE_ANDI;
-          funct3 = FUNCT3_ANDI;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_ALS_OR: {
-          optype = OPTYPE_R;
-          opcode = OPCODE_OR;
-          funct3 = FUNCT3_OR;
-          funct7 = FUNCT7_OR;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_ALS_ORI: {
-          optype = OPTYPE_I;
-          opcode = OPCODE_ORI;
-          funct3 = FUNCT3_ORI;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_ALS_XOR: {
-          optype = OPTYPE_R;
-          opcode = OPCODE_XOR;
-          funct3 = FUNCT3_XOR;
-          funct7 = FUNCT7_XOR;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_ALS_XORI: {
-          optype = OPTYPE_I;
-          opcode = OPCODE_XORI;
-          funct3 = FUNCT3_XORI;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_ALS_SLL: {
-          optype = OPTYPE_R;
-          opcode = OPCODE_SLL;
-          funct3 = FUNCT3_SLL;
-          funct7 = FUNCT7_SLL;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_ALS_SLLI: {
-          optype = OPTYPE_I;
-          opcode = OPCODE_SLLI;
-          funct3 = FUNCT3_SLLI;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_ALS_SRL: {
-          optype = OPTYPE_R;
-          opcode = OPCODE_SRL;
-          funct3 = FUNCT3_SRL;
-          funct7 = FUNCT7_SRL;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_ALS_SRLI: {
-          optype = OPTYPE_I;
-          opcode = OPCODE_SRLI;
-          funct3 = FUNCT3_SRLI;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_ALS_SRA: {
-          optype = OPTYPE_R;
-          opcode = OPCODE_SRA;
-          funct3 = FUNCT3_SRA;
-          funct7 = FUNCT7_SRA;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_ALS_SRAI: {
-          optype = OPTYPE_I;
-          opcode = OPCODE_SRAI;
-          funct3 = FUNCT3_SRAI;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_MD_MUL: {
-          optype = OPTYPE_R;
-          opcode = OPCODE_MUL;
-          funct3 = FUNCT3_MUL;
-          funct7 = FUNCT7_MUL;
-          break;
-        }
 
-        case lexer::TOKEN_INST_32IM_MD_MULH: {
-          optype = OPTYPE_R;
-          opcode = OPCODE_MULH;
-          funct3 = FUNCT3_MULH;
-          funct7 = FUNCT7_MULH;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_MD_MULSU: {
-          optype = OPTYPE_R;
-          opcode = OPCODE_MULSU;
-          funct3 = FUNCT3_MULSU;
-          funct7 = FUNCT7_MULSU;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_MD_MULU: {
-          optype = OPTYPE_R;
-          opcode = OPCODE_MULU;
-          funct3 = FUNCT3_MULU;
-          funct7 = FUNCT7_MULU;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_MD_DIV: {
-          optype = OPTYPE_R;
-          opcode = OPCODE_DIV;
-          funct3 = FUNCT3_DIV;
-          funct7 = FUNCT7_DIV;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_MD_DIVU: {
-          optype = OPTYPE_R;
-          opcode = OPCODE_DIVU;
-          funct3 = FUNCT3_DIVU;
-          funct7 = FUNCT7_DIVU;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_MD_REM: {
-          optype = OPTYPE_R;
-          opcode = OPCODE_REM;
-          funct3 = FUNCT3_REM;
-          funct7 = FUNCT7_REM;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_MD_REMU: {
-          optype = OPTYPE_R;
-          opcode = OPCODE_REMU;
-          funct3 = FUNCT3_REMU;
-          funct7 = FUNCT7_REMU;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_LS_LB: {
-          optype = OPTYPE_I;
-          opcode = OPCODE_LB;
-          funct3 = FUNCT3_LB;
-          if (!lexer::riscv_token_is_symbol(inst->f2->type))
-            break;
-
-          const uint32_t addr = map[inst->f2->lit.string];
-          insts[s_insts++] = riscv_map_u_type(
-            addr,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_AUIPC
-          );
-          insts[s_insts++] = riscv_map_i_type(
-            addr,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_LB,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_LB
-          );
-          continue;
-        }
-
-        case lexer::TOKEN_INST_32IM_LS_LH: {
-          optype = OPTYPE_I;
-          opcode = OPCODE_LH;
-          funct3 = FUNCT3_LH;
-          if (!lexer::riscv_token_is_symbol(inst->f2->type))
-            break;
-
-          const uint32_t addr = map[inst->f2->lit.string];
-          insts[s_insts++] = riscv_map_u_type(
-            addr,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_AUIPC
-          );
-          insts[s_insts++] = riscv_map_i_type(
-            addr,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_LH,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_LH
-          );
-          continue;
-        }
-
-        case lexer::TOKEN_INST_32IM_LS_LW: {
-          optype = OPTYPE_I;
-          opcode = OPCODE_LW;
-          funct3 = FUNCT3_LW;
-          if (!lexer::riscv_token_is_symbol(inst->f2->type))
-            break;
- 
-          const uint32_t addr = map[inst->f2->lit.string];
-          insts[s_insts++] = riscv_map_u_type(
-            addr,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_AUIPC
-          );
-          insts[s_insts++] = riscv_map_i_type(
-            addr,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_LW,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_LW
-          );
-          continue;
-        }
-
-        case lexer::TOKEN_INST_32IM_LS_LBU: {
-          optype = OPTYPE_I;
-          opcode = OPCODE_LBU;
-          funct3 = FUNCT3_LBU;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_LS_LHU: {
-          optype = OPTYPE_I;
-          opcode = OPCODE_LHU;
-          funct3 = FUNCT3_LHU;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_LS_SB: {
-          optype = OPTYPE_S;
-          opcode = OPCODE_SB;
-          funct3 = FUNCT3_SB;
-          if (!lexer::riscv_token_is_symbol(inst->f2->type))
-            break;
-
-          const uint32_t addr = map[inst->f2->lit.string];
-          insts[s_insts++] = riscv_map_u_type(
-            addr,
-            lexer::riscv_token_get_reg(inst->f3->type, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_AUIPC
-          );
-          insts[s_insts++] = riscv_map_s_type(
-            addr,
-            lexer::riscv_token_get_reg(inst->f3->type, __FUNCTION__, __FILE__, __LINE__),
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_SB,
-            OPCODE_SB
-          );
-          continue;
-        }
-
-        case lexer::TOKEN_INST_32IM_LS_SH: {
-          optype = OPTYPE_S;
-          opcode = OPCODE_SH;
-          funct3 = FUNCT3_SH;
-          if (!lexer::riscv_token_is_symbol(inst->f2->type))
-            break;
-
-          const uint32_t addr = map[inst->f2->lit.string];
-          insts[s_insts++] = riscv_map_u_type(
-            addr,
-            lexer::riscv_token_get_reg(inst->f3->type, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_AUIPC
-          );
-          insts[s_insts++] = riscv_map_s_type(
-            addr,
-            lexer::riscv_token_get_reg(inst->f3->type, __FUNCTION__, __FILE__, __LINE__),
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_SH,
-            OPCODE_SH
-          );
-          continue;
-        }
-
-        case lexer::TOKEN_INST_32IM_LS_SW: {
-          optype = OPTYPE_S;
-          opcode = OPCODE_SW;
-          funct3 = FUNCT3_SW;
-          if (!lexer::riscv_token_is_symbol(inst->f2->type))
-            break;
-
-          const uint32_t addr = map[inst->f2->lit.string];
-          insts[s_insts++] = riscv_map_u_type(
-            addr,
-            lexer::riscv_token_get_reg(inst->f3->type, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_AUIPC
-          );
-          insts[s_insts++] = riscv_map_s_type(
-            addr,
-            lexer::riscv_token_get_reg(inst->f3->type, __FUNCTION__, __FILE__, __LINE__),
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_SW,
-            OPCODE_SW
-          );
-          continue;
-        }
-
-        case lexer::TOKEN_INST_32IM_CP_SLT: {
-          optype = OPTYPE_R;
-          opcode = OPCODE_SLT;
-          funct3 = FUNCT3_SLT;
-          funct7 = FUNCT7_SLT;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_CP_SLTI: {
-          optype = OPTYPE_I;
-          opcode = OPCODE_SLTI;
-          funct3 = FUNCT3_SLTI;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_CP_SLTU: {
-          optype = OPTYPE_R;
-          opcode = OPCODE_SLTU;
-          funct3 = FUNCT3_SLTU;
-          funct7 = FUNCT7_SLTU;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_CP_SLTIU: {
-          optype = OPTYPE_I;
-          opcode = OPCODE_SLTIU;
-          funct3 = FUNCT3_SLTIU;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_CP_SEQZ: {
-          insts[s_insts++] = riscv_map_i_type(
-            1,
-            lexer::riscv_token_get_reg(inst->f2->type, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_SLTIU,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_SLTIU
-          );
-          continue;
-        }
-
-        case lexer::TOKEN_INST_32IM_CP_SNEZ: {
-          insts[s_insts++] = riscv_map_r_type(
-            FUNCT7_SLTU,
-            lexer::riscv_token_get_reg(inst->f2->type, __FUNCTION__, __FILE__, __LINE__),
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_SLTU,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_SLTU
-          );
-          continue;
-        }
-
-        case lexer::TOKEN_INST_32IM_CP_SLTZ: {
-          insts[s_insts++] = riscv_map_r_type(
-            FUNCT7_SLT,
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            lexer::riscv_token_get_reg(inst->f2->type, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_SLT,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_SLT
-          );
-          continue;
-        }
-
-        case lexer::TOKEN_INST_32IM_CP_SGTZ: {
-          insts[s_insts++] = riscv_map_r_type(
-            FUNCT7_SLT,
-            lexer::riscv_token_get_reg(inst->f2->type, __FUNCTION__, __FILE__, __LINE__),
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_SLT,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_SLT
-          );
-          continue;
-        }
-
-        case lexer::TOKEN_INST_32IM_FC_BEQ: {
-          optype = OPTYPE_B;
-          opcode = OPCODE_BEQ;
-          funct3 = FUNCT3_BEQ;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_FC_BNE: {
-          optype = OPTYPE_B;
-          opcode = OPCODE_BNE;
-          funct3 = FUNCT3_BNE;
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_FC_BGT: {
-          const uint32_t offset = lexer::riscv_token_is_symbol(inst->f3->type) 
-            ? riscv_map_relative_addr(pc, map[inst->f3->lit.string])
-            : inst->f3->lit.number;
-
-          insts[s_insts++] = riscv_map_b_type(
-            offset,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            lexer::riscv_token_get_reg(inst->f2->type, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_BLT,
-            OPCODE_BLT
-          );
-          continue;
-        }
-
-        case lexer::TOKEN_INST_32IM_FC_BGE: {
-          optype = OPTYPE_B;
-          opcode = OPCODE_BGE;
-          funct3 = FUNCT3_BGE;
-          break;
-        }
+    // with every address known an instruction only depends on its own pc,
+    // so chunks are encoded side by side into insts, which holds exactly
+    // the words the layout counted
+    if (s_chunks == 1) {
+      riscv_map_chunk(&chunks[0], ir, sizes, addrs, text_addr, insts);
+    } else {
+      std::vector<std::thread> threads;
+      for (uint64_t c = 0; c < s_chunks; c++)
+        threads.emplace_back([&, chunk = &chunks[c]]() { riscv_map_chunk(chunk, ir, sizes, addrs, text_addr, insts); });
+      for (std::thread& thread : threads)
+        thread.join();
+    }
+    trace(TRACE_MAPPER, "mapper - encoded words: ", s_insts, __FILE__, __LINE__);
+    trace(TRACE_MAPPER, "mapper - encoded on threads: ", s_chunks, __FILE__, __LINE__);
+    free(chunks);
+  }
 
-        case lexer::TOKEN_INST_32IM_FC_BLE: {
-          const uint32_t offset = lexer::riscv_token_is_symbol(inst->f3->type) 
-            ? riscv_map_relative_addr(pc, map[inst->f3->lit.string])
-            : inst->f3->lit.number;
-
-          insts[s_insts++] = riscv_map_b_type(
-            offset,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            lexer::riscv_token_get_reg(inst->f2->type, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_BGE,
-            OPCODE_BGE
-          );
-          continue;
-        }
+  uint32_t map_data_size(const parser::RISCVAST* ast) {
+    error(FATAL, ast == nullptr, "mapper - ast is a nullptr in ", __FUNCTION__, __FILE__, __LINE__);
 
-        case lexer::TOKEN_INST_32IM_FC_BLT: {
-          optype = OPTYPE_B;
-          opcode = OPCODE_BLT;
-          funct3 = FUNCT3_BLT;
-          break;
-        }
+    uint64_t s_data = 0;
+    for (uint64_t i = 0; i < ast->s_data; i++)
+      s_data += riscv_map_data_size(parser::ast_data_size(ast, &ast->data[i]));
+    return (uint32_t)(s_data >> 2); // directives are padded to whole words
+  }
 
-        case lexer::TOKEN_INST_32IM_FC_BGTU: {
-          const uint32_t offset = lexer::riscv_token_is_symbol(inst->f3->type) 
-            ? riscv_map_relative_addr(pc, map[inst->f3->lit.string])
-            : inst->f3->lit.number;
-
-          insts[s_insts++] = riscv_map_b_type(
-            offset,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            lexer::riscv_token_get_reg(inst->f2->type, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_BLTU,
-            OPCODE_BLTU
-          );
-          continue;
-        }
+  void map_data2bin(const parser::RISCVAST* ast, uint32_t* data) {
+    error(FATAL, ast == nullptr, "mapper - ast is a nullptr in ", __FUNCTION__, __FILE__, __LINE__);
+    const lexer::RISCVTokenStream* tokens = ast->tokens;
 
-        case lexer::TOKEN_INST_32IM_FC_BGEU: {
-          optype = OPTYPE_B;
-          opcode = OPCODE_BGEU;
-          funct3 = FUNCT3_BGEU;
-          break;
-        }
+    // data holds the map_data_size words, zeroed, so only the bytes a
+    // directive covers are written and its padding is left as it is
+    uint8_t* bytes = (uint8_t*)data;
+    for (uint64_t i = 0; i < ast->s_data; i++) {
+      const lexer::RISCVTokenType type = lexer::riscv_tokens_get_type(tokens, ast->data[i].type);
+      const uint32_t s_bytes = type == lexer::TOKEN_STRING
+        ? riscv_map_data_strings(tokens, &ast->data[i], bytes)
+        : riscv_map_data_numbers(tokens, &ast->data[i], lexer::riscv_token_get_type_size(type), bytes);
+      bytes += riscv_map_data_size(s_bytes);
+    }
+  }
 
-        case lexer::TOKEN_INST_32IM_FC_BLTU: {
-          optype = OPTYPE_B;
-          opcode = OPCODE_BLTU;
-          funct3 = FUNCT3_BLTU;
-          break;
-        }
+  void map_output(const char* filename, RISCVEncoding& encoding) {
+    const uint64_t len_filename = strlen(filename);
+    error(
+      FATAL,
+      len_filename < 2,
+      "mapper - filename as length less than 2 (it should end in \".s\"): ",
+      filename,
+      __FILE__,
+      __LINE__
+    );
 
-        case lexer::TOKEN_INST_32IM_FC_BLEU: {
-          const uint32_t offset = lexer::riscv_token_is_symbol(inst->f3->type) 
-            ? riscv_map_relative_addr(pc, map[inst->f3->lit.string])
-            : inst->f3->lit.number;
-
-          insts[s_insts++] = riscv_map_b_type(
-            offset,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            lexer::riscv_token_get_reg(inst->f2->type, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_BGEU,
-            OPCODE_BGEU
-          );
-          continue;
-        }
+    char* output_filename = (char*)malloc((len_filename + 3) * sizeof(char));
+    error(FATAL, output_filename == nullptr, "mapper - could not allocate memory for output filename", "", __FILE__, __LINE__);
+    strncpy(output_filename, filename, len_filename + 3);
+    output_filename[len_filename - 2] = '.';
+    output_filename[len_filename - 1] = 'b';
+    output_filename[len_filename] = 'i';
+    output_filename[len_filename + 1] = 'n';
+    output_filename[len_filename + 2] = '\0';
 
-        case lexer::TOKEN_INST_32IM_FC_BEQZ: {
-          insts[s_insts++] = riscv_map_b_type(
-            riscv_map_relative_addr(pc, map[inst->f2->lit.string]),
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_BEQ,
-            OPCODE_BEQ
-          );
-          continue;
-        }
+    // the file is sized up front, so it reads back as zeros wherever
+    // nothing is encoded and the sections are written in place
+    encoding.s_file = (MAPPER_S_HEADER + (uint64_t)encoding.s_insts + encoding.s_data) * sizeof(uint32_t);
+    const int fd = open(output_filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    error(FATAL, fd < 0, "mapper - could not open output file ", output_filename, __FILE__, __LINE__);
+    error(FATAL, ftruncate(fd, (off_t)encoding.s_file) < 0, "mapper - could not size output file ", output_filename, __FILE__, __LINE__);
+
+    void* file = mmap(nullptr, (size_t)encoding.s_file, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    error(FATAL, file == MAP_FAILED, "mapper - could not map output file ", output_filename, __FILE__, __LINE__);
+    close(fd);
+    trace(TRACE_MAPPER, "mapper - mapped output file ", output_filename, __FILE__, __LINE__);
+
+    encoding.file  = (uint32_t*)file;
+    encoding.insts = encoding.file + MAPPER_S_HEADER;
+    encoding.data  = encoding.insts + encoding.s_insts;
+    free(output_filename);
+  }
 
-        case lexer::TOKEN_INST_32IM_FC_BNEZ: {
-          insts[s_insts++] = riscv_map_b_type(
-            riscv_map_relative_addr(pc, map[inst->f2->lit.string]),
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_BNE,
-            OPCODE_BNE
-          );
-          continue;
-        }
+  void unmap_output(RISCVEncoding& encoding) {
+    error(FATAL, encoding.file == nullptr, "mapper - output file is not mapped in ", __FUNCTION__, __FILE__, __LINE__);
 
-        case lexer::TOKEN_INST_32IM_FC_BLEZ: {
-          insts[s_insts++] = riscv_map_b_type(
-            riscv_map_relative_addr(pc, map[inst->f2->lit.string]),
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_BGE,
-            OPCODE_BGE
-          );
-          continue;
-        }
+    // the header goes last, data_addr and stack_addr come out of encoding
+    const uint32_t header[MAPPER_S_HEADER] = {
+      encoding.s_insts, encoding.s_data, encoding.s_stack,
+      encoding.text_addr, encoding.data_addr, encoding.stack_addr
+    };
+    memcpy(encoding.file, header, sizeof(header));
 
-        case lexer::TOKEN_INST_32IM_FC_BGEZ: {
-          insts[s_insts++] = riscv_map_b_type(
-            riscv_map_relative_addr(pc, map[inst->f2->lit.string]),
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_BGE,
-            OPCODE_BGE
-          );
-          continue;
-        }
+    munmap(encoding.file, (size_t)encoding.s_file);
+    trace(TRACE_MAPPER, "mapper - instructions written to the output file", "", __FILE__, __LINE__);
+    encoding.file  = nullptr;
+    encoding.insts = nullptr;
+    encoding.data  = nullptr;
+  }
 
-        case lexer::TOKEN_INST_32IM_FC_BLTZ: {
-          insts[s_insts++] = riscv_map_b_type(
-            riscv_map_relative_addr(pc, map[inst->f2->lit.string]),
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_BLT,
-            OPCODE_BLT
-          );
-          continue;
-        }
+  void map_disassemble(const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    error(FATAL, file == nullptr, "mapper - could not open binary file ", filename, __FILE__, __LINE__);
+
+    uint32_t header[MAPPER_S_HEADER];
+    error(FATAL, fread(header, sizeof(uint32_t), MAPPER_S_HEADER, file) != MAPPER_S_HEADER, "mapper - binary file has no header: ", filename, __FILE__, __LINE__);
+    const uint32_t
+      s_insts = header[0], s_data = header[1], s_stack = header[2],
+      text_addr = header[3], data_addr = header[4], stack_addr = header[5];
+
+    uint32_t* words = (uint32_t*)malloc(((uint64_t)s_insts + s_data + 1) * sizeof(uint32_t));
+    error(FATAL, words == nullptr, "mapper - allocation of binary words returned a nullptr", "", __FILE__, __LINE__);
+    error(FATAL, fread(words, sizeof(uint32_t), (uint64_t)s_insts + s_data, file) != (uint64_t)s_insts + s_data, "mapper - binary file is shorter than its header says: ", filename, __FILE__, __LINE__);
+    fclose(file);
+
+    printf(".text @ 0x%08x, size: %u bytes\n", text_addr, s_insts << 2);
+    for (uint32_t i = 0; i < s_insts; i++) {
+      const uint32_t pc = text_addr + (i << 2);
+      parser::RISCVIR_Inst inst;
+      printf("0x%08x ", pc);
+      if (riscv_map_decode(words[i], inst))
+        riscv_map_print_inst(&inst, pc);
+      else
+        printf(".word 0x%08x", words[i]);
+      printf("\n");
+    }
 
-        case lexer::TOKEN_INST_32IM_FC_BGTZ: {
-          insts[s_insts++] = riscv_map_b_type(
-            riscv_map_relative_addr(pc, map[inst->f2->lit.string]),
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_BLT,
-            OPCODE_BLT
-          );
-          continue;
-        }
+    printf("\n.data @ 0x%08x, size: %u bytes\n", data_addr, s_data << 2);
+    for (uint32_t i = 0; i < s_data; i++)
+      printf("0x%08x .word 0x%08x\n", data_addr + (i << 2), words[s_insts + i]);
 
-        case lexer::TOKEN_INST_32IM_FC_J: {
-          insts[s_insts++] = riscv_map_j_type(
-            riscv_map_relative_addr(pc, map[inst->f1->lit.string]),
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_JAL
-          );
-          continue;
-        }
+    printf("\n.stack @ 0x%08x, size: %u bytes\n", stack_addr, s_stack << 2);
+    free(words);
+  }
+}
 
-        case lexer::TOKEN_INST_32IM_FC_JAL: {
-          optype = OPTYPE_J;
-          opcode = OPCODE_JAL;
-          if (inst->f2 != nullptr)
-            break;
-
-          insts[s_insts++] = riscv_map_j_type(
-            riscv_map_relative_addr(pc, map[inst->f1->lit.string]),
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X1, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_JAL
-          );
-          continue;
-        }
+uint32_t riscv_map_inst(
+  const parser::RISCVIR_Inst* inst, const uint32_t s_inst, const uint32_t pc,
+  const std::vector<uint32_t>& addrs, uint32_t* insts
+) {
+  // returns the number of words written, anything that is a single word is
+  // its RISCV_ISA row packed by its format; s_inst is what the layout gave
+  // it, which for a branch says whether it was relaxed
+  const MapperIsaInst* isa = &MAPPER_ISA.insts[inst->op];
+  if (riscv_map_is_expanded(isa, inst))
+    return riscv_map_expand(isa, inst, pc, addrs, insts);
+  if (s_inst == 2 && riscv_map_is_branch(inst))
+    return riscv_map_relax(isa, inst, pc, addrs, insts);
+
+  insts[0] = riscv_map_pack(isa, inst, pc, addrs);
+  return 1;
+}
 
-        case lexer::TOKEN_INST_32IM_FC_JR: {
-          insts[s_insts++] = riscv_map_i_type(
-            0x0,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_JALR,
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_JALR
-          );
-          continue;
-        }
+uint32_t riscv_map_expand(
+  const MapperIsaInst* isa, const parser::RISCVIR_Inst* inst, const uint32_t pc,
+  const std::vector<uint32_t>& addrs, uint32_t* insts
+) {
+  const MapperIsaInst
+    *auipc = &MAPPER_ISA.insts[lexer::TOKEN_INST_32IM_MOVE_AUIPC],
+    *addi  = &MAPPER_ISA.insts[lexer::TOKEN_INST_32IM_ALS_ADDI],
+    *jalr  = &MAPPER_ISA.insts[lexer::TOKEN_INST_32IM_FC_JALR];
+
+  uint32_t s_insts = 0;
+  switch (inst->op) {
+    case lexer::TOKEN_INST_32IM_MOVE_LA: {
+      const uint32_t target_addr = riscv_map_symbol_addr(addrs, inst->symbol);
+      const int32_t offset = (int32_t)riscv_map_relative_addr(pc, target_addr);
+
+      /*
+       * used for debug
+      std::cout << "LA: pc=0x" << std::hex << pc 
+                << " target=0x" << target_addr 
+                << " offset=" << std::dec << offset << std::endl;
+       * */
+
+      // Split with proper sign handling
+      int32_t
+        upper = offset & 0xFFFFF000,
+        lower = offset & 0xFFF;
+
+      // If lower will be sign-extended as negative by addi, compensate upper
+      if (lower & 0x800)
+        upper += 0x1000;
+
+      insts[s_insts++] = riscv_map_u_type(upper, inst->rd, auipc->opcode);
+      insts[s_insts++] = riscv_map_i_type(lower, inst->rd, addi->funct3, inst->rd, addi->opcode);
+      return s_insts;
+    }
 
-        case lexer::TOKEN_INST_32IM_FC_JALR: {
-          optype = OPTYPE_I;
-          opcode = OPCODE_JALR;
-          if (inst->f2 != nullptr)
-            break;
-
-          insts[s_insts++] = riscv_map_i_type(
-            0x0,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_JALR,
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X1, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_JALR
-          );
-          continue;
-        }
+    case lexer::TOKEN_INST_32IM_MOVE_LI:
+      return riscv_map_li(inst->imm, inst->rd, insts);
 
-        case lexer::TOKEN_INST_32IM_FC_CALL: {
-          insts[s_insts++] = riscv_map_u_type(
-            inst->f1->lit.number,
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X1, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_AUIPC
-          );
-          insts[s_insts++] = riscv_map_i_type(
-            inst->f1->lit.number,
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X1, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_JALR,
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_JALR
-          );
-          continue;
-        }
+    case lexer::TOKEN_INST_32IM_FC_CALL: {
+      insts[s_insts++] = riscv_map_u_type(inst->imm, REG_X1, auipc->opcode);
+      insts[s_insts++] = riscv_map_i_type(inst->imm, REG_X1, jalr->funct3, REG_X0, jalr->opcode);
+      return s_insts;
+    }
 
-        case lexer::TOKEN_INST_32IM_FC_RET: {
-          insts[s_insts++] = riscv_map_i_type(
-            0x0,
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X1, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_JALR,
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_JALR
-          );
-          continue;
-        }
+    default: {
+      // a load or a store of a symbol, the address goes through the base
+      // register, which for a load is the one being loaded
+      const uint32_t addr = riscv_map_symbol_addr(addrs, inst->symbol);
+      if (isa->format == ISA_FORMAT_I) {
+        insts[s_insts++] = riscv_map_u_type(addr, inst->rd, auipc->opcode);
+        insts[s_insts++] = riscv_map_i_type(addr, inst->rd, isa->funct3, inst->rd, isa->opcode);
+        return s_insts;
+      }
 
-        case lexer::TOKEN_INST_32IM_OS_ECALL: {
-          insts[s_insts++] = riscv_map_i_type(
-            IMM_ECALL,
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            0x0,
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_OS
-          );
-          continue;
-        }
+      // the grammar has no scratch register operand for a store to a symbol
+      error(FATAL, inst->rs1 == IR_REG_NONE, "mapper - store to a symbol has no base register in ", __FUNCTION__, __FILE__, __LINE__);
+      insts[s_insts++] = riscv_map_u_type(addr, inst->rs1, auipc->opcode);
+      insts[s_insts++] = riscv_map_s_type(addr, inst->rs2, inst->rs1, isa->funct3, isa->opcode);
+      return s_insts;
+    }
+  }
+}
 
-        case lexer::TOKEN_INST_32IM_OS_EBREAK: {
-          insts[s_insts++] = riscv_map_i_type(
-            IMM_EBREAK,
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            0x0,
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_OS
-          );
-          continue;
-        }
+uint32_t riscv_map_li(const int32_t imm, const uint8_t rd, uint32_t* insts) {
+  const MapperIsaInst
+    *lui  = &MAPPER_ISA.insts[lexer::TOKEN_INST_32IM_MOVE_LUI],
+    *addi = &MAPPER_ISA.insts[lexer::TOKEN_INST_32IM_ALS_ADDI];
+
+  // a 12 bit signed value is a single addi and one with its low 12 bits
+  // clear a single lui; anything else is lui then addi, and since addi sign
+  // extends, the upper part is rounded up when bit 11 is set; the sum wraps
+  // like the registers do, which covers 0x7FFFF800 and above
+  if (imm >= -2048 && imm <= 2047) {
+    insts[0] = riscv_map_i_type((uint16_t)imm, REG_X0, addi->funct3, rd, addi->opcode);
+    return 1;
+  }
+  if ((imm & 0xFFF) == 0) {
+    insts[0] = riscv_map_u_type((uint32_t)imm, rd, lui->opcode);
+    return 1;
+  }
 
-        case lexer::TOKEN_INST_32IM_OS_SRET: {
-          insts[s_insts++] = riscv_map_i_type(
-            IMM_SRET,
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            0x0,
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_OS
-          );
-          continue;
-        }
+  insts[0] = riscv_map_u_type((uint32_t)imm + 0x800, rd, lui->opcode);
+  insts[1] = riscv_map_i_type((uint16_t)imm, rd, addi->funct3, rd, addi->opcode);
+  return 2;
+}
 
-        case lexer::TOKEN_INST_32IM_LNS_ADD: {
-          optype = OPTYPE_R;
-          opcode = OPCODE_LNS_ADD;
-          funct3 = FUNCT3_LNS_ADD;
-          funct7 = FUNCT7_LNS_ADD;
-          break;
-        }
+uint32_t riscv_map_relax(
+  const MapperIsaInst* isa, const parser::RISCVIR_Inst* inst, const uint32_t pc,
+  const std::vector<uint32_t>& addrs, uint32_t* insts
+) {
+  // the opposite condition is the other funct3 of its pair (beq/bne,
+  // blt/bge, bltu/bgeu), it skips the jal that takes the original one
+  const MapperIsaInst* jal = &MAPPER_ISA.insts[lexer::TOKEN_INST_32IM_FC_JAL];
+  MapperIsaInst inverted = *isa;
+  inverted.funct3 ^= 1;
+  parser::RISCVIR_Inst skip = *inst;
+  skip.symbol = IR_SYMBOL_NONE;
+  skip.imm    = 8;
+
+  insts[0] = riscv_map_pack(&inverted, &skip, pc, addrs);
+  const int32_t offset = (int32_t)riscv_map_relative_addr(pc + 4, riscv_map_symbol_addr(addrs, inst->symbol));
+  error(FATAL, !riscv_map_fits_jump(offset), "mapper - relaxed branch target is out of jal range: ", offset, __FILE__, __LINE__);
+  insts[1] = riscv_map_j_type((uint32_t)offset, REG_X0, jal->opcode);
+  return 2;
+}
 
-        case lexer::TOKEN_INST_32IM_LNS_SUB: {
-          optype = OPTYPE_R;
-          opcode = OPCODE_LNS_SUB;
-          funct3 = FUNCT3_LNS_SUB;
-          funct7 = FUNCT7_LNS_SUB;
-          break;
-        }
+inline bool riscv_map_is_branch(const parser::RISCVIR_Inst* inst) {
+  // only a branch to a label can be relaxed, an explicit offset is kept
+  return inst->op != IR_OP_LABEL && MAPPER_ISA.insts[inst->op].format == ISA_FORMAT_B && inst->symbol != IR_SYMBOL_NONE;
+}
 
-        case lexer::TOKEN_INST_32IM_LNS_MUL: {
-          optype = OPTYPE_R;
-          opcode = OPCODE_LNS_MUL;
-          funct3 = FUNCT3_LNS_MUL;
-          funct7 = FUNCT7_LNS_MUL;
-          break;
-        }
+void riscv_map_label_offsets(const parser::RISCVIR* ir, const uint8_t* sizes, std::vector<uint32_t>& offsets) {
+  // byte offset of every label from the start of .text, first definition wins
+  std::fill(offsets.begin(), offsets.end(), MAPPER_ADDR_NONE);
+  uint64_t at = 0;
+  for (uint64_t i = 0; i < ir->s_insts; i++) {
+    if (ir->insts[i].op == IR_OP_LABEL && offsets[ir->insts[i].symbol] == MAPPER_ADDR_NONE)
+      offsets[ir->insts[i].symbol] = (uint32_t)(at << 2);
+    at += sizes[i];
+  }
+}
 
-        case lexer::TOKEN_INST_32IM_LNS_DIV: {
-          optype = OPTYPE_R;
-          opcode = OPCODE_LNS_DIV;
-          funct3 = FUNCT3_LNS_DIV;
-          funct7 = FUNCT7_LNS_DIV;
-          break;
-        }
+inline bool riscv_map_fits_branch(const int64_t offset) {
+  return offset >= -4096 && offset <= 4094;
+}
 
-        case lexer::TOKEN_INST_32IM_LNS_SQT: {
-          insts[s_insts++] = riscv_map_r_type(
-            FUNCT7_LNS_SQT,
-            lexer::riscv_token_get_reg(lexer::TOKEN_REG_X0, __FUNCTION__, __FILE__, __LINE__),
-            lexer::riscv_token_get_reg(inst->f2->type, __FUNCTION__, __FILE__, __LINE__),
-            FUNCT3_LNS_SQT,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            OPCODE_LNS_SQT
-          );
-          continue;
-        }
+inline bool riscv_map_fits_jump(const int64_t offset) {
+  return offset >= -(1 << 20) && offset <= (1 << 20) - 2;
+}
 
-        default: {
-          error(
-            FATAL,
-            true,
-            "mapper - unknown instruction type in ",
-            __FUNCTION__,
-            __FILE__,
-            __LINE__
-          );
-        }
-      }
+inline bool riscv_map_is_expanded(const MapperIsaInst* isa, const parser::RISCVIR_Inst* inst) {
+  // loads and stores take a symbol in place of an offset from a register
+  return isa->kind == ISA_KIND_EXPAND || (
+    (isa->opcode == ISA_OPCODE_LOAD || isa->opcode == ISA_OPCODE_STORE) &&
+    inst->symbol != IR_SYMBOL_NONE
+  );
+}
 
-      switch (optype) {
-        case OPTYPE_R: {
-          insts[s_insts++] = riscv_map_r_type(
-            funct7,
-            lexer::riscv_token_get_reg(inst->f3->type, __FUNCTION__, __FILE__, __LINE__),
-            lexer::riscv_token_get_reg(inst->f2->type, __FUNCTION__, __FILE__, __LINE__),
-            funct3,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            opcode
-          );
-          break;
-        }
-        case OPTYPE_I: {
-          const bool                  load_or_jalr = (
-            lexer::riscv_token_is_inst_load(inst->inst->type) ||
-            inst->inst->type == lexer::TOKEN_INST_32IM_FC_JALR
-          );
-
-          const int32_t               imm = load_or_jalr ? inst->f2->lit.number : inst->f3->lit.number;
-          const lexer::RISCVTokenType rs1 = load_or_jalr ? inst->f3->type       : inst->f2->type;
-
-          insts[s_insts++] = riscv_map_i_type(
-            imm,
-            lexer::riscv_token_get_reg(rs1, __FUNCTION__, __FILE__, __LINE__),
-            funct3,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            opcode
-          );
-          break;
-        }
-        case OPTYPE_S: {
-          insts[s_insts++] = riscv_map_s_type(
-            inst->f2->lit.number,
-            lexer::riscv_token_get_reg(inst->f3->type, __FUNCTION__, __FILE__, __LINE__),
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            funct3,
-            opcode
-          );
-          break;
-        }
-        case OPTYPE_B: {
-          const uint32_t offset = lexer::riscv_token_is_symbol(inst->f3->type) 
-            ? riscv_map_relative_addr(pc, map[inst->f3->lit.string])
-            : inst->f3->lit.number;
-
-          insts[s_insts++] = riscv_map_b_type(
-            offset,
-            lexer::riscv_token_get_reg(inst->f2->type, __FUNCTION__, __FILE__, __LINE__),
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            funct3,
-            opcode
-          );
-          break;
-        }
-        case OPTYPE_U: {
-          insts[s_insts++] = riscv_map_u_type(
-            inst->f2->lit.number,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            opcode
-          );
-          break;
-        }
-        case OPTYPE_J: {
-          const uint32_t offset = lexer::riscv_token_is_symbol(inst->f2->type) 
-            ? riscv_map_relative_addr(pc, map[inst->f2->lit.string])
-            : inst->f2->lit.number;
-
-          insts[s_insts++] = riscv_map_j_type(
-            offset,
-            lexer::riscv_token_get_reg(inst->f1->type, __FUNCTION__, __FILE__, __LINE__),
-            opcode
-          );
-          break;
-        }
-        default: {
-          error(
-            FATAL,
-            true,
-            "mapper - invalid optype in ",
-            __FUNCTION__,
-            __FILE__,
-            __LINE__
-          );
-        }
-      }
+inline uint32_t riscv_map_pack(
+  const MapperIsaInst* isa, const parser::RISCVIR_Inst* inst,
+  const uint32_t pc, const std::vector<uint32_t>& addrs
+) {
+  // the register sources index this, in ISA_REG_* order
+  const uint8_t regs[] = {
+    REG_X0, inst->rd, inst->rs1, inst->rs2,
+    REG_X0, REG_X1, inst->rd != IR_REG_NONE ? inst->rd : (uint8_t)REG_X1
+  };
+  const uint8_t
+    rd  = regs[isa->rd],
+    rs1 = regs[isa->rs1],
+    rs2 = regs[isa->rs2];
+  const int32_t imm = isa->imm == ISA_IMM ? inst->imm : isa->imm;
+
+  switch (isa->format) {
+    case ISA_FORMAT_R:
+      return riscv_map_r_type(isa->funct7, rs2, rs1, isa->funct3, rd, isa->opcode);
+    case ISA_FORMAT_I:
+      return riscv_map_i_type(imm, rs1, isa->funct3, rd, isa->opcode);
+    case ISA_FORMAT_SHIFT:
+      return riscv_map_i_type((imm & 0x1F) | (isa->funct7 << 5), rs1, isa->funct3, rd, isa->opcode);
+    case ISA_FORMAT_S:
+      return riscv_map_s_type(imm, rs2, rs1, isa->funct3, isa->opcode);
+    case ISA_FORMAT_U:
+      return riscv_map_u_type(imm, rd, isa->opcode);
+    case ISA_FORMAT_B:
+    case ISA_FORMAT_J: {
+      const uint32_t offset = inst->symbol != IR_SYMBOL_NONE
+        ? riscv_map_relative_addr(pc, riscv_map_symbol_addr(addrs, inst->symbol))
+        : imm;
+
+      // branches to labels were relaxed to reach them, so only an explicit
+      // offset or a jal past 1 MiB ends up here
+      error(
+        FATAL,
+        isa->format == ISA_FORMAT_B ? !riscv_map_fits_branch((int32_t)offset) : !riscv_map_fits_jump((int32_t)offset),
+        "mapper - branch or jump offset is out of range: ",
+        (int32_t)offset,
+        __FILE__,
+        __LINE__
+      );
+      return isa->format == ISA_FORMAT_B
+        ? riscv_map_b_type(offset, rs2, rs1, isa->funct3, isa->opcode)
+        : riscv_map_j_type(offset, rd, isa->opcode);
     }
+    default: {
+      error(
+        FATAL,
+        true,
+        "mapper - unknown instruction type in ",
+        __FUNCTION__,
+        __FILE__,
+        __LINE__
+      );
+      return 0;
+    }
+  }
+}
 
-    return insts;
+void riscv_map_chunk(
+  const MapperChunk* chunk, const parser::RISCVIR* ir, const uint8_t* sizes,
+  const std::vector<uint32_t>& addrs, const uint32_t text_addr, uint32_t* insts
+) {
+  uint64_t at = chunk->at;
+  for (uint64_t i = chunk->begin; i < chunk->end; i++) {
+    if (sizes[i] == 0)
+      continue;
+    const uint32_t s_inst = riscv_map_inst(&ir->insts[i], sizes[i], text_addr + (uint32_t)(at << 2), addrs, insts + at);
+    error(FATAL, s_inst != sizes[i], "mapper - instruction size differs from its layout in ", __FUNCTION__, __FILE__, __LINE__);
+    at += s_inst;
   }
+}
 
-  uint32_t* map_data2bin(const parser::RISCVAST* ast, uint32_t& s_data) {
-    error(FATAL, ast == nullptr, "mapper - ast is a nullptr in ", __FUNCTION__, __FILE__, __LINE__);
+uint32_t riscv_map_inst_size(const parser::RISCVIR_Inst* inst) {
+  // has to agree with what riscv_map_inst writes, map_inst2bin checks it does
+  if (inst->op == IR_OP_LABEL)
+    return 0;
+  if (!riscv_map_is_expanded(&MAPPER_ISA.insts[inst->op], inst))
+    return 1;
 
-    uint64_t total_s_data = 0;
-    for (uint64_t i = 0; i < ast->s_data; i++) {
-      if (ast->data[i].type->type != lexer::TOKEN_STRING) {
-        total_s_data += lexer::riscv_token_get_type_size(ast->data[i].type->type) * ast->data[i].s_arr;
-        continue;
-      }
+  // li is sized by synthesizing it, which is a handful of compares
+  uint32_t li[2];
+  return inst->op == lexer::TOKEN_INST_32IM_MOVE_LI ? riscv_map_li(inst->imm, inst->rd, li) : 2;
+}
 
-      for (uint64_t j = 0; j < ast->data[i].s_arr; j++)
-        total_s_data += strlen(ast->data[i].arr[j]->lit.string) + 1;
+bool riscv_map_decode(const uint32_t word, parser::RISCVIR_Inst& inst) {
+  inst = (parser::RISCVIR_Inst){
+    .op     = lexer::TOKEN_NONE,
+    .rd     = IR_REG_NONE,
+    .rs1    = IR_REG_NONE,
+    .rs2    = IR_REG_NONE,
+    .imm    = 0,
+    .symbol = IR_SYMBOL_NONE
+  };
+
+  // RISCV_ISA guarantees at most one base instruction fits, aliases are never
+  // given back since their base spells the same word
+  for (uint32_t type = lexer::TOKEN_INST_32IM_NOP; type < lexer::TOKEN_INST_32IM_MAX; type++) {
+    const MapperIsaInst* isa = &MAPPER_ISA.insts[type];
+    if (isa->kind != ISA_KIND_BASE || (word & isa->mask) != isa->match)
+      continue;
+
+    inst.op = (uint8_t)type;
+    const uint8_t sources[3] = { isa->rd, isa->rs1, isa->rs2 };
+    const uint8_t fields[3]  = { (uint8_t)((word >> 7) & 0x1F), (uint8_t)((word >> 15) & 0x1F), (uint8_t)((word >> 20) & 0x1F) };
+    for (uint32_t k = 0; k < 3; k++) {
+      switch (sources[k]) {
+        case ISA_REG_RD:
+        case ISA_REG_RD_RA: { inst.rd  = fields[k]; break; }
+        case ISA_REG_RS1:   { inst.rs1 = fields[k]; break; }
+        case ISA_REG_RS2:   { inst.rs2 = fields[k]; break; }
+        default:            break;
+      }
     }
 
-    s_data = (total_s_data >> 2) + ((total_s_data & 0b11) > 0); // number of words + padding to allocate
-    uint32_t* data = (uint32_t*)malloc(s_data * sizeof(uint32_t));
-    error(FATAL, data == nullptr, "mapper - allocation of data array returned a nullptr in ", __FUNCTION__, __FILE__, __LINE__);
-
-    uint64_t k = 0;
-    for (uint64_t i = 0; i < ast->s_data; i++) {
-      const bool string = ast->data[i].type->type == lexer::TOKEN_STRING;
-
-      if (string) {
-        for (uint64_t j = 0; j < ast->data[i].s_arr; j++) {
-          char* c = ast->data[i].arr[j]->lit.string;
-          error(FATAL, c == nullptr, "mapper - literal string is a nullptr in a TOKEN_LIT_STRING", "", __FILE__, __LINE__);
-
-          for (uint8_t l = 0; true; l = (l + 1) & 4, c++) {
-            data[k] ^= (uint32_t)(*c) << (l << 3);
-            k += l == 3;
-            if (*c == '\0')
-              break;
-          }
-        }
-
-        continue;
+    switch (isa->format) {
+      case ISA_FORMAT_I:     { inst.imm = riscv_map_sign_extend(word >> 20, 12); break; }
+      case ISA_FORMAT_SHIFT: { inst.imm = (int32_t)((word >> 20) & 0x1F); break; }
+      case ISA_FORMAT_S:     { inst.imm = riscv_map_sign_extend(((word >> 25) << 5) | ((word >> 7) & 0x1F), 12); break; }
+      case ISA_FORMAT_U:     { inst.imm = (int32_t)(word & 0xFFFFF000); break; }
+      case ISA_FORMAT_B: {
+        inst.imm = riscv_map_sign_extend(
+          ((word >> 31) << 12) | (((word >> 7) & 0x1) << 11) |
+          (((word >> 25) & 0x3F) << 5) | (((word >> 8) & 0xF) << 1),
+          13
+        );
+        break;
       }
-
-      const uint64_t 
-        c      = lexer::riscv_token_get_type_size(ast->data[i].type->type),
-        s_word = lexer::riscv_token_get_type_size(lexer::TOKEN_WORD),
-        s_half = lexer::riscv_token_get_type_size(lexer::TOKEN_HALF);
-
-      for (uint64_t j = 0; j < ast->data[i].s_arr; j += s_word - c + 1) {
-        uint32_t word = 0;
-
-        if (c == s_word) {
-          word ^= (uint32_t)ast->data[i].arr[j]->lit.number;
-        } else if (c == s_half) {
-          word ^= (uint32_t)ast->data[i].arr[j]->lit.number;
-          word ^= j + 1 < ast->data[i].s_arr ? (uint32_t)ast->data[i].arr[j + 1]->lit.number << 16 : 0;
-        } else {
-          word ^= (uint32_t)ast->data[i].arr[j]->lit.number;
-          word ^= j + 1 < ast->data[i].s_arr ? (uint32_t)ast->data[i].arr[j + 1]->lit.number << 8 : 0;
-          word ^= j + 2 < ast->data[i].s_arr ? (uint32_t)ast->data[i].arr[j + 2]->lit.number << 16 : 0;
-          word ^= j + 3 < ast->data[i].s_arr ? (uint32_t)ast->data[i].arr[j + 3]->lit.number << 24 : 0;
-        }
-
-        data[k++] |= word;
+      case ISA_FORMAT_J: {
+        inst.imm = riscv_map_sign_extend(
+          ((word >> 31) << 20) | (((word >> 12) & 0xFF) << 12) |
+          (((word >> 20) & 0x1) << 11) | (((word >> 21) & 0x3FF) << 1),
+          21
+        );
+        break;
       }
+      default: break;
     }
-
-    return data;
+    return true;
   }
+  return false;
+}
 
-  void write(const char* filename, const RISCVEncoding& encoding) {
-    const uint64_t len_filename = strlen(filename);
-    error(
-      FATAL,
-      len_filename < 2,
-      "mapper - filename as length less than 2 (it should end in \".s\"): ",
-      filename,
-      __FILE__,
-      __LINE__
-    );
-
-    char* output_filename = (char*)malloc((len_filename + 3) * sizeof(char));
-    error(FATAL, output_filename == nullptr, "mapper - could not allocate memory for output filename", "", __FILE__, __LINE__);
-    strncpy(output_filename, filename, len_filename + 3);
-    output_filename[len_filename - 2] = '.';
-    output_filename[len_filename - 1] = 'b';
-    output_filename[len_filename] = 'i';
-    output_filename[len_filename + 1] = 'n';
-    output_filename[len_filename + 2] = '\0';
+void riscv_map_print_inst(const parser::RISCVIR_Inst* inst, const uint32_t pc) {
+  const MapperIsaInst* isa = &MAPPER_ISA.insts[inst->op];
+  printf("%s", isa->mnemonic);
 
-    std::ofstream file(output_filename, std::ios::binary);
-    error(FATAL, !file.is_open(), "mapper - could not open output file ", filename, __FILE__, __LINE__);
-    log("mapper - opened output file ", filename, __FILE__, __LINE__);
+  // operands as the assembler takes them back
+  if (isa->format == ISA_FORMAT_S) {
+    printf(" x%u, %d(x%u)", inst->rs2, inst->imm, inst->rs1);
+    return;
+  }
+  if (isa->opcode == ISA_OPCODE_LOAD || isa->opcode == ISA_OPCODE_JALR) {
+    printf(" x%u, %d(x%u)", inst->rd, inst->imm, inst->rs1);
+    return;
+  }
 
-    file.write(reinterpret_cast<const char*>(&encoding.s_insts),    sizeof(uint32_t));
-    file.write(reinterpret_cast<const char*>(&encoding.s_data),     sizeof(uint32_t));
-    file.write(reinterpret_cast<const char*>(&encoding.s_stack),    sizeof(uint32_t));
-    file.write(reinterpret_cast<const char*>(&encoding.text_addr),  sizeof(uint32_t));
-    file.write(reinterpret_cast<const char*>(&encoding.data_addr),  sizeof(uint32_t));
-    file.write(reinterpret_cast<const char*>(&encoding.stack_addr), sizeof(uint32_t));
+  const char* sep = " ";
+  const uint8_t regs[3] = { inst->rd, inst->rs1, inst->rs2 };
+  for (uint32_t k = 0; k < 3; k++) {
+    if (regs[k] == IR_REG_NONE)
+      continue;
+    printf("%sx%u", sep, regs[k]);
+    sep = ", ";
+  }
 
-    file.write(
-      reinterpret_cast<const char*>(encoding.insts),
-      encoding.s_insts * sizeof(uint32_t)
-    );
+  if (isa->imm != ISA_IMM)
+    return;
+  if (isa->format == ISA_FORMAT_U)
+    printf("%s0x%x", sep, (uint32_t)inst->imm);
+  else
+    printf("%s%d", sep, inst->imm);
+  if (isa->format == ISA_FORMAT_B || isa->format == ISA_FORMAT_J)
+    printf(" # 0x%08x", pc + (uint32_t)inst->imm);
+}
 
-    file.write(
-      reinterpret_cast<const char*>(encoding.data),
-      encoding.s_data * sizeof(uint32_t)
-    );
+inline int32_t riscv_map_sign_extend(const uint32_t x, const uint32_t bits) {
+  return (int32_t)(x << (32 - bits)) >> (32 - bits);
+}
 
-    log("mapper - instructions written to the output file", filename, __FILE__, __LINE__);
-    free(output_filename);
-  }
+inline uint32_t riscv_map_symbol_addr(const std::vector<uint32_t>& addrs, const uint32_t symbol) {
+  // the parser rejects undefined symbols, the layout has placed every one
+  return addrs[symbol];
 }
 
 inline uint32_t riscv_map_r_type(
@@ -1269,14 +663,72 @@ inline uint32_t riscv_map_relative_addr(const uint32_t pc, const uint32_t addr)
   return static_cast<uint32_t>(((int32_t)addr - (int32_t)pc));
 }
 
-inline uint32_t next_pow2(uint32_t x) {
-  if (x == 0)
-    return 1;
-  x--;
-  x |= x >> 1;
-  x |= x >> 2;
-  x |= x >> 4;
-  x |= x >> 8;
-  x |= x >> 16;
-  return x + 1;
+uint32_t riscv_map_data_strings(const lexer::RISCVTokenStream* tokens, const parser::RISCVASTN_Data* node, uint8_t* bytes) {
+  // strings are decoded straight out of the source, back to back and NUL
+  // terminated, the terminator is already there in the zeroed image
+  uint8_t* at = bytes;
+  for (uint64_t j = 0; j < node->s_lits; j++) {
+    lexer::riscv_tokens_copy_string(tokens, parser::ast_get_lit(node, j), (char*)at);
+    at += lexer::riscv_tokens_get_string_size(tokens, parser::ast_get_lit(node, j)) + 1;
+  }
+  return (uint32_t)(at - bytes);
+}
+
+uint32_t riscv_map_data_numbers(const lexer::RISCVTokenStream* tokens, const parser::RISCVASTN_Data* node, const uint64_t s_lit, uint8_t* bytes) {
+  // literal j is every other token after the type, the parser checked that
+  // each fits s_lit bytes, which are stored little endian like the target
+  const lexer::RISCVTokenLit* lits = &tokens->lits[parser::ast_get_lit(node, 0)];
+  const uint64_t s_lits = node->s_lits;
+
+  uint64_t j = 0;
+#if MAPPER_DATA_SSE2
+  // the even lanes of a run of literal tokens are narrowed with signed packs,
+  // which keep the low bits exactly once they are sign extended from them;
+  // the strict bound keeps the last load off the token after the run
+  if (s_lit == 1) {
+    for (; j + 16 < s_lits; j += 16) {
+      const __m128i
+        w0 = riscv_map_sse2_evens(lits + (j << 1)),      w1 = riscv_map_sse2_evens(lits + (j << 1) + 8),
+        w2 = riscv_map_sse2_evens(lits + (j << 1) + 16), w3 = riscv_map_sse2_evens(lits + (j << 1) + 24);
+      const __m128i
+        h0 = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(w0, 24), 24), _mm_srai_epi32(_mm_slli_epi32(w1, 24), 24)),
+        h1 = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(w2, 24), 24), _mm_srai_epi32(_mm_slli_epi32(w3, 24), 24));
+      _mm_storeu_si128((__m128i*)(bytes + j), _mm_packs_epi16(h0, h1));
+    }
+  } else if (s_lit == 2) {
+    for (; j + 8 < s_lits; j += 8) {
+      const __m128i w0 = riscv_map_sse2_evens(lits + (j << 1)), w1 = riscv_map_sse2_evens(lits + (j << 1) + 8);
+      _mm_storeu_si128(
+        (__m128i*)(bytes + (j << 1)),
+        _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(w0, 16), 16), _mm_srai_epi32(_mm_slli_epi32(w1, 16), 16))
+      );
+    }
+  } else {
+    for (; j + 4 < s_lits; j += 4)
+      _mm_storeu_si128((__m128i*)(bytes + (j << 2)), riscv_map_sse2_evens(lits + (j << 1)));
+  }
+#endif
+
+  for (; j < s_lits; j++) {
+    const uint32_t number = (uint32_t)lits[j << 1].number;
+    for (uint64_t b = 0; b < s_lit; b++)
+      bytes[j * s_lit + b] = (uint8_t)(number >> (b << 3));
+  }
+  return (uint32_t)(s_lits * s_lit);
+}
+
+#if MAPPER_DATA_SSE2
+inline __m128i riscv_map_sse2_evens(const lexer::RISCVTokenLit* lits) {
+  // the literals of lits[0, 2, 4, 6], the commas between them are dropped
+  return _mm_castps_si128(_mm_shuffle_ps(
+    _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)lits)),
+    _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(lits + 4))),
+    _MM_SHUFFLE(2, 0, 2, 0)
+  ));
+}
+#endif
+
+uint32_t riscv_map_data_size(const uint32_t size) {
+  // every directive starts on a word, which is how map_data2bin lays them out
+  return (size + 0b11) & ~(uint32_t)0b11;
 }
@@ -0,0 +1,229 @@
+#include "mapper_private.hpp"
+
+static const char* MAPPER_SECTION_NAMES[] = { ".text", ".data", ".stack" };
+
+namespace mapper {
+  bool map_layout_parse(const char* text, const char* source, RISCVLayout& layout) {
+    error(FATAL, text == nullptr, "mapper - layout text is a nullptr in ", __FUNCTION__, __FILE__, __LINE__);
+
+    layout.s_regions = 0;
+    layout.s_stack   = 0;
+    layout.text = layout.data = layout.stack = (RISCVSection){
+      .region = MAPPER_REGION_NONE,
+      .align  = MAPPER_ALIGN_WORD
+    };
+
+    // statements end at a ';' or a newline and a '#' comments out the rest
+    // of its line; every statement is looked at, so all mistakes get reported
+    bool ok = true;
+    uint32_t line = 1;
+    const char* str = text;
+    while (*str != '\0') {
+      MapperLayoutWord words[MAPPER_LAYOUT_MAX_S_WORDS];
+      uint32_t s_words = 0;
+      const uint32_t line_stmt = line;
+
+      for (;;) {
+        for (; *str == ' ' || *str == '\t' || *str == '\r'; str++);
+        if (*str == '#')
+          for (; *str != '\0' && *str != '\n'; str++);
+        if (*str == '\0' || *str == '\n' || *str == ';')
+          break;
+
+        const char* word = str;
+        for (; *str != '\0' && strchr(" \t\r\n;#", *str) == nullptr; str++);
+        if (s_words < MAPPER_LAYOUT_MAX_S_WORDS)
+          words[s_words] = (MapperLayoutWord){ .str = word, .s_str = (uint32_t)(str - word) };
+        s_words++;
+      }
+      line += *str == '\n';
+      str  += *str != '\0';
+
+      error(ERROR, s_words > MAPPER_LAYOUT_MAX_S_WORDS, "mapper - layout statement has more words than any statement takes", "", source, line_stmt);
+      if (s_words > 0)
+        ok = s_words <= MAPPER_LAYOUT_MAX_S_WORDS && riscv_map_layout_stmt(words, s_words, layout, source, line_stmt) && ok;
+    }
+
+    const RISCVSection* sections[] = { &layout.text, &layout.data, &layout.stack };
+    for (uint32_t s = 0; s < sizeof(sections) / sizeof(sections[0]); s++) {
+      const bool placed = sections[s]->region != MAPPER_REGION_NONE;
+      error(ERROR, !placed, "mapper - layout does not place section ", MAPPER_SECTION_NAMES[s], source, line);
+      ok = placed && ok;
+    }
+    return ok;
+  }
+
+  bool map_layout_load(const char* filename, RISCVLayout& layout) {
+    FILE* file = fopen(filename, "rb");
+    error(FATAL, file == nullptr, "mapper - could not open layout file ", filename, __FILE__, __LINE__);
+
+    fseek(file, 0, SEEK_END);
+    const long s_text = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    error(FATAL, s_text < 0, "mapper - could not size layout file ", filename, __FILE__, __LINE__);
+
+    char* text = (char*)malloc((size_t)s_text + 1);
+    error(FATAL, text == nullptr, "mapper - allocation of layout text returned a nullptr", "", __FILE__, __LINE__);
+    error(FATAL, fread(text, sizeof(char), (size_t)s_text, file) != (size_t)s_text, "mapper - could not read layout file ", filename, __FILE__, __LINE__);
+    text[s_text] = '\0';
+    fclose(file);
+
+    const bool ok = map_layout_parse(text, filename, layout);
+    free(text);
+    return ok;
+  }
+
+  bool map_layout(const RISCVLayout& layout, RISCVEncoding& encoding) {
+    encoding.s_stack = layout.s_stack;
+
+    // every region fills up from its origin, a section starts on the first
+    // aligned byte past the sections placed in its region before it
+    uint64_t cursors[MAPPER_MAX_S_REGIONS];
+    for (uint32_t r = 0; r < layout.s_regions; r++)
+      cursors[r] = layout.regions[r].origin;
+
+    const RISCVSection* sections[] = { &layout.text, &layout.data, &layout.stack };
+    const uint64_t s_sections[] = {
+      (uint64_t)encoding.s_insts << 2, (uint64_t)encoding.s_data << 2, (uint64_t)encoding.s_stack << 2
+    };
+    uint32_t* addrs[] = { &encoding.text_addr, &encoding.data_addr, &encoding.stack_addr };
+
+    bool ok = true;
+    for (uint32_t s = 0; s < sizeof(sections) / sizeof(sections[0]); s++) {
+      const RISCVRegion& region = layout.regions[sections[s]->region];
+      const uint64_t
+        begin = (cursors[sections[s]->region] + sections[s]->align - 1) & ~((uint64_t)sections[s]->align - 1),
+        end   = begin + s_sections[s],
+        limit = (uint64_t)region.origin + region.length;
+
+      if (end > limit) {
+        char msg[64 + MAPPER_S_REGION_NAME];
+        snprintf(msg, sizeof(msg), "mapper - section %s overflows region %s by bytes: ", MAPPER_SECTION_NAMES[s], region.name);
+        error(ERROR, true, msg, end - limit, __FILE__, __LINE__);
+        ok = false;
+      }
+
+      *addrs[s] = (uint32_t)begin;
+      cursors[sections[s]->region] = end;
+      trace(TRACE_MAPPER, "mapper - placed section at ", begin, __FILE__, __LINE__);
+    }
+    return ok;
+  }
+}
+
+bool riscv_map_layout_stmt(
+  const MapperLayoutWord* words, const uint32_t s_words,
+  mapper::RISCVLayout& layout, const char* source, const uint32_t line
+) {
+  if (riscv_map_layout_is(words[0], "text") || riscv_map_layout_is(words[0], "data"))
+    return riscv_map_layout_sect(words, s_words, 2, layout, words[0].str[0] == 't' ? layout.text : layout.data, source, line);
+
+  if (riscv_map_layout_is(words[0], "stack")) {
+    // stack <region> <bytes> [align <bytes>]
+    uint64_t s_stack = 0;
+    const bool valid = s_words >= 3 && riscv_map_layout_number(words[2], s_stack) && (s_stack & 0b11) == 0 && s_stack < (1ull << 32);
+    error(ERROR, !valid, "mapper - layout stack takes a region and a size in whole words", "", source, line);
+    if (!valid)
+      return false;
+
+    layout.s_stack = (uint32_t)(s_stack >> 2);
+    return riscv_map_layout_sect(words, s_words, 3, layout, layout.stack, source, line);
+  }
+
+  if (riscv_map_layout_is(words[0], "region")) {
+    // region <name> <origin> <length>
+    uint64_t origin = 0, length = 0;
+    const bool valid =
+      s_words == 4 && words[1].s_str < MAPPER_S_REGION_NAME &&
+      riscv_map_layout_number(words[2], origin) && riscv_map_layout_number(words[3], length);
+    error(ERROR, !valid, "mapper - layout region takes a name, an origin and a length, names are at most 15 characters", "", source, line);
+    if (!valid)
+      return false;
+
+    mapper::RISCVRegion region = { .name = {}, .origin = (uint32_t)origin, .length = length };
+    memcpy(region.name, words[1].str, words[1].s_str);
+
+    const bool fits = length > 0 && origin + length <= (1ull << 32);
+    error(ERROR, !fits, "mapper - layout region is empty or runs past the 32 bit address space: ", region.name, source, line);
+    error(ERROR, riscv_map_layout_region(layout, words[1]) != MAPPER_REGION_NONE, "mapper - layout declares region twice: ", region.name, source, line);
+    error(ERROR, layout.s_regions >= MAPPER_MAX_S_REGIONS, "mapper - layout has more regions than it can hold: ", MAPPER_MAX_S_REGIONS, source, line);
+    if (!fits || riscv_map_layout_region(layout, words[1]) != MAPPER_REGION_NONE || layout.s_regions >= MAPPER_MAX_S_REGIONS)
+      return false;
+
+    bool ok = true;
+    for (uint32_t r = 0; r < layout.s_regions; r++) {
+      const mapper::RISCVRegion& other = layout.regions[r];
+      const bool overlap = origin < other.origin + other.length && other.origin < origin + length;
+      error(ERROR, overlap, "mapper - layout region overlaps region ", other.name, source, line);
+      ok = !overlap && ok;
+    }
+
+    layout.regions[layout.s_regions++] = region;
+    return ok;
+  }
+
+  error(ERROR, true, "mapper - layout statement is none of region, text, data or stack", "", source, line);
+  return false;
+}
+
+bool riscv_map_layout_sect(
+  const MapperLayoutWord* words, const uint32_t s_words, const uint32_t s_fixed,
+  mapper::RISCVLayout& layout, mapper::RISCVSection& section, const char* source, const uint32_t line
+) {
+  // the first s_fixed words name the section, its region and for the stack
+  // its size, an alignment can follow them
+  uint64_t align = MAPPER_ALIGN_WORD;
+  const bool valid =
+    s_words == s_fixed ||
+    (s_words == s_fixed + 2 && riscv_map_layout_is(words[s_fixed], "align") && riscv_map_layout_number(words[s_fixed + 1], align));
+  error(ERROR, !valid, "mapper - layout section takes a region and then optionally align <bytes>", "", source, line);
+  if (!valid)
+    return false;
+
+  const uint32_t region = riscv_map_layout_region(layout, words[1]);
+  const bool pow2 = align >= MAPPER_ALIGN_WORD && align <= (1ull << 31) && (align & (align - 1)) == 0;
+  error(ERROR, region == MAPPER_REGION_NONE, "mapper - layout places a section in a region that is not declared before it", "", source, line);
+  error(ERROR, !pow2, "mapper - layout alignment is not a power of two of at least 4: ", align, source, line);
+  error(ERROR, section.region != MAPPER_REGION_NONE, "mapper - layout places a section twice", "", source, line);
+  if (region == MAPPER_REGION_NONE || !pow2 || section.region != MAPPER_REGION_NONE)
+    return false;
+
+  section = (mapper::RISCVSection){ .region = region, .align = (uint32_t)align };
+  return true;
+}
+
+uint32_t riscv_map_layout_region(const mapper::RISCVLayout& layout, const MapperLayoutWord& word) {
+  for (uint32_t r = 0; r < layout.s_regions; r++)
+    if (strlen(layout.regions[r].name) == word.s_str && memcmp(layout.regions[r].name, word.str, word.s_str) == 0)
+      return r;
+  return MAPPER_REGION_NONE;
+}
+
+bool riscv_map_layout_number(const MapperLayoutWord& word, uint64_t& value) {
+  // decimal or 0x hexadecimal, a K, M or G suffix scales by 2^10, 2^20 or
+  // 2^30; nothing past 2^32 means anything in a 32 bit address space
+  if (word.s_str == 0 || word.s_str >= MAPPER_LAYOUT_MAX_S_NUMBER || word.str[0] < '0' || word.str[0] > '9')
+    return false;
+
+  char digits[MAPPER_LAYOUT_MAX_S_NUMBER];
+  memcpy(digits, word.str, word.s_str);
+  digits[word.s_str] = '\0';
+
+  const char suffix = digits[word.s_str - 1];
+  const uint32_t shift = suffix == 'K' ? 10 : (suffix == 'M' ? 20 : (suffix == 'G' ? 30 : 0));
+  digits[word.s_str - 1] = shift > 0 ? '\0' : suffix;
+
+  const bool hexa = digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X');
+  const char* begin = hexa ? digits + 2 : digits;
+  char* end = nullptr;
+  value = strtoull(begin, &end, hexa ? 16 : 10);
+  if (!isxdigit((uint8_t)begin[0]) || *end != '\0' || value > ((1ull << 32) >> shift))
+    return false;
+
+  value <<= shift;
+  return value <= (1ull << 32);
+}
+
+inline bool riscv_map_layout_is(const MapperLayoutWord& word, const char* keyword) {
+  return strlen(keyword) == word.s_str && memcmp(keyword, word.str, word.s_str) == 0;
+}
@@ -3,34 +3,118 @@
 
 #include "lexer.hpp"
 
+#define AST_TOKEN_NONE UINT32_MAX
+
+// text nodes live in fixed size chunks, growing the tree never moves a node
+#define AST_S_CHUNK_BITS 12
+#define AST_S_CHUNK      (1u << AST_S_CHUNK_BITS)
+
+// operands are stored as 4 bit offsets from the instruction token, the
+// longest form "<inst> <xd>, <imm>(<xa>)" puts its last operand 5 tokens on
+#define AST_S_FIELDS     3
+#define AST_FIELD_BITS   4
+#define AST_FIELD_MASK   ((1u << AST_FIELD_BITS) - 1)
+
+#define IR_OP_LABEL      lexer::TOKEN_SYMBOL
+#define IR_SYMBOL_NONE   UINT32_MAX
+#define IR_REG_NONE      UINT8_MAX
+
 namespace parser {
   typedef struct riscv_ast       RISCVAST;
   typedef struct riscv_astn_text RISCVASTN_Text;
   typedef struct riscv_astn_data RISCVASTN_Data;
+  typedef struct riscv_ast_ref   RISCVAST_Ref;
+
+  typedef struct riscv_ir        RISCVIR;
+  typedef struct riscv_ir_inst   RISCVIR_Inst;
+  typedef struct riscv_ir_data   RISCVIR_Data;
 
-  RISCVAST*   parse          (lexer::RISCVToken*, const uint64_t);
-  void        check          (RISCVAST*);
+  RISCVAST*   parse          (const lexer::RISCVTokenStream*);
+  RISCVAST*   parse_stream   (const char*, lexer::RISCVTokenStream*);
+  RISCVAST*   parse_parallel (const lexer::RISCVTokenStream*, const uint32_t);
 
   void        ast_print      (const RISCVAST*);
   void        ast_free       (RISCVAST*);
+  uint32_t    ast_data_size  (const RISCVAST*, const RISCVASTN_Data*);
 
+  RISCVIR*    lower          (const RISCVAST*);
+  void        ir_free        (RISCVIR*);
+
+  inline const RISCVASTN_Text* ast_get_text  (const RISCVAST*, const uint64_t);
+  inline uint32_t              ast_get_field (const RISCVASTN_Text*, const uint32_t);
+  inline uint32_t              ast_get_lit   (const RISCVASTN_Data*, const uint64_t);
+
+  // nodes refer to tokens by their index in ast->tokens, operand k of a node
+  // sits (fields >> (k - 1) * AST_FIELD_BITS) & AST_FIELD_MASK tokens after
+  // inst, 0 meaning the operand is absent, form is the grammar form it matched
   struct riscv_astn_text {
-    lexer::RISCVToken
-      *inst, *f1, *f2, *f3, *f4;
+    uint32_t inst;
+    uint16_t fields;
+    uint8_t  form;
   };
 
+  // literals are comma separated right after the type token, so a data node
+  // only counts them and literal j is read at type + 1 + 2 * j
   struct riscv_astn_data {
-    uint64_t s_arr;
-    lexer::RISCVToken
-      *symbol, *type, **arr;
+    uint32_t symbol, type, s_lits;
   };
 
+  // a symbol referenced before anything defined it, line is where it first was
+  struct riscv_ast_ref {
+    uint32_t symbol, line;
+  };
+
+  // the string table only holds symbols, so its ids number them densely;
+  // defined and referenced have a bit per id, refs are checked once parsing
+  // is done and those still undefined are reported
   struct riscv_ast {
     bool error;
-    uint64_t s_data, s_text;
-    struct riscv_astn_data* data;
-    struct riscv_astn_text  text[];
+    const lexer::RISCVTokenStream* tokens;
+    uint64_t s_data, s_text, s_chunks;
+    uint32_t s_symbols, max_s_symbols;
+    uint64_t s_refs, max_s_refs;
+    struct riscv_astn_data*  data;
+    struct riscv_astn_text** text;
+    uint64_t *defined, *referenced;
+    struct riscv_ast_ref* refs;
   };
+
+  // the lowered program, instructions carry register numbers and resolved
+  // immediates so that encoding never looks at a token again
+  struct riscv_ir_inst {
+    uint8_t  op; // token type of the instruction, IR_OP_LABEL for a label
+    uint8_t  rd, rs1, rs2; // IR_REG_NONE when the form has no such operand
+    int32_t  imm;
+    uint32_t symbol; // interned id of the label or symbol operand, IR_SYMBOL_NONE if there is none
+  };
+
+  // data directives are only needed for their addresses, size is in bytes
+  struct riscv_ir_data {
+    uint32_t symbol, size;
+  };
+
+  // symbol ids run from 0 to s_symbols, every one that is referenced is defined
+  struct riscv_ir {
+    uint64_t s_insts, s_data;
+    uint32_t s_symbols;
+    struct riscv_ir_inst* insts;
+    struct riscv_ir_data* data;
+  };
+
+  static_assert(sizeof(RISCVASTN_Text) == 8, "text nodes are packed into 8 bytes");
+
+  inline const RISCVASTN_Text* ast_get_text(const RISCVAST* ast, const uint64_t i) {
+    return &ast->text[i >> AST_S_CHUNK_BITS][i & (AST_S_CHUNK - 1)];
+  }
+
+  inline uint32_t ast_get_field(const RISCVASTN_Text* node, const uint32_t k) {
+    const uint32_t offset = (node->fields >> ((k - 1) * AST_FIELD_BITS)) & AST_FIELD_MASK;
+    return offset == 0 ? AST_TOKEN_NONE : node->inst + offset;
+  }
+
+  inline uint32_t ast_get_lit(const RISCVASTN_Data* node, const uint64_t j) {
+    return node->type + 1 + (uint32_t)(j << 1);
+  }
 }
 
 #endif // !__PARSER_H_
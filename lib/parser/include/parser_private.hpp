@@ -1,16 +1,21 @@
 #ifndef __PARSER_PRIVATE_H__
 #define __PARSER_PRIVATE_H__
 
+#include <mutex>
+#include <condition_variable>
+
 #include "parser.hpp"
 
+#define CHECK_ERROR_MSG_0 \
+  "parser - the following instruction takes no parameters: "
 #define CHECK_ERROR_MSG_J \
   "parser - field type is not symbol for instruction "
 #define CHECK_ERROR_MSG_JR_CALL \
   "parser - field type is not register for instruction "
 #define CHECK_ERROR_MSG_JAL \
-  "parser - invalid field types (should be: jal <symbol> || jal <xd>, <imm>) for instruction "
+  "parser - invalid field types (should be: jal <symbol> || jal <xd>, <imm|symbol>) for instruction "
 #define CHECK_ERROR_MSG_JALR \
-  "parser - invalid field types (should be: jalr <xs> || jalr <xd>, <xa>, <imm>) for instruction "
+  "parser - invalid field types (should be: jalr <xs> || jalr <xd>, <imm>(<xa>)) for instruction "
 #define CHECK_ERROR_MSG_1 \
   "parser - invalid field types (should be: <inst> <xd>, <imm>) for instruction "
 #define CHECK_ERROR_MSG_2 \
@@ -18,15 +23,259 @@
 #define CHECK_ERROR_MSG_3 \
   "parser - invalid field types (should be: <inst> <xd>, <xs>) for instruction "
 #define CHECK_ERROR_MSG_4 \
-  "parser - invalid field types (should be: <inst> <xd>, <xa>, <symbol>) for instruction "
+  "parser - invalid field types (should be: <inst> <xa>, <xb>, <imm|symbol>) for instruction "
 #define CHECK_ERROR_MSG_5 \
   "parser - invalid field types (should be: <inst> <xd>, <xa>, <imm>) for instruction "
 #define CHECK_ERROR_MSG_6 \
   "parser - invalid field types (should be: <inst> <xd>, <xa>, <xb>) for instruction "
 #define CHECK_ERROR_MSG_LS \
-  "parser - invalid field types (should be: <inst> <xd>, <imm>(<xa>) || <l{b,h,w}> <xd>, <symbol> || <s{b,h,w}> <xd>, <symbol>, <xt>) in "
+  "parser - invalid field types (should be: <inst> <xd>, <imm>(<xa>) || <inst> <xd>, <symbol>) in "
+#define CHECK_ERROR_MSG_WIDTH \
+  "parser - number literal does not fit the width of directive "
+
+// operand classes of the instruction grammar, a slot accepts any class in its mask
+#define OPERAND_REG 0x1
+#define OPERAND_IMM 0x2
+#define OPERAND_SYM 0x4
+
+#define PARSER_MAX_OPERANDS 3
+#define PARSER_MAX_FORMS    2
+
+// the widest form spans 2 * PARSER_MAX_OPERANDS tokens, which a field offset has to reach
+static_assert(PARSER_MAX_OPERANDS <= AST_S_FIELDS && 2 * PARSER_MAX_OPERANDS <= AST_FIELD_MASK, "parser - forms do not fit a text node");
+
+// what an operand becomes in the lowered instruction, an immediate and a
+// symbol share ROLE_IMM since a form slot may accept either
+#define ROLE_RD  0
+#define ROLE_RS1 1
+#define ROLE_RS2 2
+#define ROLE_IMM 3
+
+typedef struct parser_form {
+  uint8_t s_operands;
+  uint8_t operands[PARSER_MAX_OPERANDS];
+  uint8_t roles[PARSER_MAX_OPERANDS];
+  bool    mem; // written as <xd>, <imm>(<xa>), the last two operands are offset and base
+} ParserForm;
+
+inline constexpr ParserForm FORM_NONE     = { 0, { 0, 0, 0 }, { 0, 0, 0 }, false };
+inline constexpr ParserForm FORM_R        = { 1, { OPERAND_REG, 0, 0 }, { ROLE_RS1, 0, 0 }, false };
+inline constexpr ParserForm FORM_S        = { 1, { OPERAND_SYM, 0, 0 }, { ROLE_IMM, 0, 0 }, false };
+inline constexpr ParserForm FORM_RI       = { 2, { OPERAND_REG, OPERAND_IMM, 0 }, { ROLE_RD, ROLE_IMM, 0 }, false };
+inline constexpr ParserForm FORM_RS       = { 2, { OPERAND_REG, OPERAND_SYM, 0 }, { ROLE_RD, ROLE_IMM, 0 }, false };
+inline constexpr ParserForm FORM_RS_SRC   = { 2, { OPERAND_REG, OPERAND_SYM, 0 }, { ROLE_RS1, ROLE_IMM, 0 }, false };
+inline constexpr ParserForm FORM_RS_STORE = { 2, { OPERAND_REG, OPERAND_SYM, 0 }, { ROLE_RS2, ROLE_IMM, 0 }, false };
+inline constexpr ParserForm FORM_RL       = { 2, { OPERAND_REG, OPERAND_IMM | OPERAND_SYM, 0 }, { ROLE_RD, ROLE_IMM, 0 }, false };
+inline constexpr ParserForm FORM_RR       = { 2, { OPERAND_REG, OPERAND_REG, 0 }, { ROLE_RD, ROLE_RS1, 0 }, false };
+inline constexpr ParserForm FORM_RRI      = { 3, { OPERAND_REG, OPERAND_REG, OPERAND_IMM }, { ROLE_RD, ROLE_RS1, ROLE_IMM }, false };
+inline constexpr ParserForm FORM_RRL      = { 3, { OPERAND_REG, OPERAND_REG, OPERAND_IMM | OPERAND_SYM }, { ROLE_RS1, ROLE_RS2, ROLE_IMM }, false };
+inline constexpr ParserForm FORM_RRR      = { 3, { OPERAND_REG, OPERAND_REG, OPERAND_REG }, { ROLE_RD, ROLE_RS1, ROLE_RS2 }, false };
+inline constexpr ParserForm FORM_RM       = { 3, { OPERAND_REG, OPERAND_IMM, OPERAND_REG }, { ROLE_RD, ROLE_IMM, ROLE_RS1 }, true };
+inline constexpr ParserForm FORM_RM_STORE = { 3, { OPERAND_REG, OPERAND_IMM, OPERAND_REG }, { ROLE_RS2, ROLE_IMM, ROLE_RS1 }, true };
+
+// the whole instruction grammar, parse matches an instruction against its
+// forms in order and the first one that fits gives the node its fields
+typedef struct parser_inst_rule {
+  lexer::RISCVTokenType type;
+  uint8_t               s_forms;
+  ParserForm            forms[PARSER_MAX_FORMS];
+  const char*           msg;
+} ParserInstRule;
+
+inline constexpr ParserInstRule PARSER_INST_RULES[] = {
+  { lexer::TOKEN_INST_32IM_NOP,        1, { FORM_NONE },                    CHECK_ERROR_MSG_0 },
+  { lexer::TOKEN_INST_32IM_OS_ECALL,   1, { FORM_NONE },                    CHECK_ERROR_MSG_0 },
+  { lexer::TOKEN_INST_32IM_OS_EBREAK,  1, { FORM_NONE },                    CHECK_ERROR_MSG_0 },
+  { lexer::TOKEN_INST_32IM_OS_SRET,    1, { FORM_NONE },                    CHECK_ERROR_MSG_0 },
+  { lexer::TOKEN_INST_32IM_FC_RET,     1, { FORM_NONE },                    CHECK_ERROR_MSG_0 },
+
+  { lexer::TOKEN_INST_32IM_FC_J,       1, { FORM_S },                       CHECK_ERROR_MSG_J },
+  { lexer::TOKEN_INST_32IM_FC_JR,      1, { FORM_R },                       CHECK_ERROR_MSG_JR_CALL },
+  { lexer::TOKEN_INST_32IM_FC_CALL,    1, { FORM_R },                       CHECK_ERROR_MSG_JR_CALL },
+  { lexer::TOKEN_INST_32IM_FC_JAL,     2, { FORM_RL, FORM_S },              CHECK_ERROR_MSG_JAL },
+  { lexer::TOKEN_INST_32IM_FC_JALR,    2, { FORM_RM, FORM_R },              CHECK_ERROR_MSG_JALR },
+
+  { lexer::TOKEN_INST_32IM_MOVE_LI,    1, { FORM_RI },                      CHECK_ERROR_MSG_1 },
+  { lexer::TOKEN_INST_32IM_MOVE_LUI,   1, { FORM_RI },                      CHECK_ERROR_MSG_1 },
+  { lexer::TOKEN_INST_32IM_MOVE_AUIPC, 1, { FORM_RI },                      CHECK_ERROR_MSG_1 },
+
+  { lexer::TOKEN_INST_32IM_MOVE_LA,    1, { FORM_RS },                      CHECK_ERROR_MSG_2 },
+  { lexer::TOKEN_INST_32IM_FC_BEQZ,    1, { FORM_RS_SRC },                  CHECK_ERROR_MSG_2 },
+  { lexer::TOKEN_INST_32IM_FC_BNEZ,    1, { FORM_RS_SRC },                  CHECK_ERROR_MSG_2 },
+  { lexer::TOKEN_INST_32IM_FC_BLEZ,    1, { FORM_RS_SRC },                  CHECK_ERROR_MSG_2 },
+  { lexer::TOKEN_INST_32IM_FC_BGEZ,    1, { FORM_RS_SRC },                  CHECK_ERROR_MSG_2 },
+  { lexer::TOKEN_INST_32IM_FC_BLTZ,    1, { FORM_RS_SRC },                  CHECK_ERROR_MSG_2 },
+  { lexer::TOKEN_INST_32IM_FC_BGTZ,    1, { FORM_RS_SRC },                  CHECK_ERROR_MSG_2 },
+
+  { lexer::TOKEN_INST_32IM_MOVE_MV,    1, { FORM_RR },                      CHECK_ERROR_MSG_3 },
+  { lexer::TOKEN_INST_32IM_ALS_NEG,    1, { FORM_RR },                      CHECK_ERROR_MSG_3 },
+  { lexer::TOKEN_INST_32IM_ALS_NOT,    1, { FORM_RR },                      CHECK_ERROR_MSG_3 },
+  { lexer::TOKEN_INST_32IM_CP_SEQZ,    1, { FORM_RR },                      CHECK_ERROR_MSG_3 },
+  { lexer::TOKEN_INST_32IM_CP_SNEZ,    1, { FORM_RR },                      CHECK_ERROR_MSG_3 },
+  { lexer::TOKEN_INST_32IM_CP_SLTZ,    1, { FORM_RR },                      CHECK_ERROR_MSG_3 },
+  { lexer::TOKEN_INST_32IM_CP_SGTZ,    1, { FORM_RR },                      CHECK_ERROR_MSG_3 },
+  { lexer::TOKEN_INST_32IM_LNS_SQT,    1, { FORM_RR },                      CHECK_ERROR_MSG_3 },
+
+  { lexer::TOKEN_INST_32IM_FC_BEQ,     1, { FORM_RRL },                     CHECK_ERROR_MSG_4 },
+  { lexer::TOKEN_INST_32IM_FC_BNE,     1, { FORM_RRL },                     CHECK_ERROR_MSG_4 },
+  { lexer::TOKEN_INST_32IM_FC_BGT,     1, { FORM_RRL },                     CHECK_ERROR_MSG_4 },
+  { lexer::TOKEN_INST_32IM_FC_BGE,     1, { FORM_RRL },                     CHECK_ERROR_MSG_4 },
+  { lexer::TOKEN_INST_32IM_FC_BLE,     1, { FORM_RRL },                     CHECK_ERROR_MSG_4 },
+  { lexer::TOKEN_INST_32IM_FC_BLT,     1, { FORM_RRL },                     CHECK_ERROR_MSG_4 },
+  { lexer::TOKEN_INST_32IM_FC_BGTU,    1, { FORM_RRL },                     CHECK_ERROR_MSG_4 },
+  { lexer::TOKEN_INST_32IM_FC_BGEU,    1, { FORM_RRL },                     CHECK_ERROR_MSG_4 },
+  { lexer::TOKEN_INST_32IM_FC_BLTU,    1, { FORM_RRL },                     CHECK_ERROR_MSG_4 },
+  { lexer::TOKEN_INST_32IM_FC_BLEU,    1, { FORM_RRL },                     CHECK_ERROR_MSG_4 },
+
+  { lexer::TOKEN_INST_32IM_ALS_ADDI,   1, { FORM_RRI },                     CHECK_ERROR_MSG_5 },
+  { lexer::TOKEN_INST_32IM_ALS_ANDI,   1, { FORM_RRI },                     CHECK_ERROR_MSG_5 },
+  { lexer::TOKEN_INST_32IM_ALS_ORI,    1, { FORM_RRI },                     CHECK_ERROR_MSG_5 },
+  { lexer::TOKEN_INST_32IM_ALS_XORI,   1, { FORM_RRI },                     CHECK_ERROR_MSG_5 },
+  { lexer::TOKEN_INST_32IM_ALS_SLLI,   1, { FORM_RRI },                     CHECK_ERROR_MSG_5 },
+  { lexer::TOKEN_INST_32IM_ALS_SRLI,   1, { FORM_RRI },                     CHECK_ERROR_MSG_5 },
+  { lexer::TOKEN_INST_32IM_ALS_SRAI,   1, { FORM_RRI },                     CHECK_ERROR_MSG_5 },
+  { lexer::TOKEN_INST_32IM_CP_SLTI,    1, { FORM_RRI },                     CHECK_ERROR_MSG_5 },
+  { lexer::TOKEN_INST_32IM_CP_SLTIU,   1, { FORM_RRI },                     CHECK_ERROR_MSG_5 },
+
+  { lexer::TOKEN_INST_32IM_ALS_ADD,    1, { FORM_RRR },                     CHECK_ERROR_MSG_6 },
+  { lexer::TOKEN_INST_32IM_ALS_SUB,    1, { FORM_RRR },                     CHECK_ERROR_MSG_6 },
+  { lexer::TOKEN_INST_32IM_ALS_AND,    1, { FORM_RRR },                     CHECK_ERROR_MSG_6 },
+  { lexer::TOKEN_INST_32IM_ALS_OR,     1, { FORM_RRR },                     CHECK_ERROR_MSG_6 },
+  { lexer::TOKEN_INST_32IM_ALS_XOR,    1, { FORM_RRR },                     CHECK_ERROR_MSG_6 },
+  { lexer::TOKEN_INST_32IM_ALS_SLL,    1, { FORM_RRR },                     CHECK_ERROR_MSG_6 },
+  { lexer::TOKEN_INST_32IM_ALS_SRL,    1, { FORM_RRR },                     CHECK_ERROR_MSG_6 },
+  { lexer::TOKEN_INST_32IM_ALS_SRA,    1, { FORM_RRR },                     CHECK_ERROR_MSG_6 },
+  { lexer::TOKEN_INST_32IM_MD_MUL,     1, { FORM_RRR },                     CHECK_ERROR_MSG_6 },
+  { lexer::TOKEN_INST_32IM_MD_MULH,    1, { FORM_RRR },                     CHECK_ERROR_MSG_6 },
+  { lexer::TOKEN_INST_32IM_MD_MULSU,   1, { FORM_RRR },                     CHECK_ERROR_MSG_6 },
+  { lexer::TOKEN_INST_32IM_MD_MULU,    1, { FORM_RRR },                     CHECK_ERROR_MSG_6 },
+  { lexer::TOKEN_INST_32IM_MD_DIV,     1, { FORM_RRR },                     CHECK_ERROR_MSG_6 },
+  { lexer::TOKEN_INST_32IM_MD_DIVU,    1, { FORM_RRR },                     CHECK_ERROR_MSG_6 },
+  { lexer::TOKEN_INST_32IM_MD_REM,     1, { FORM_RRR },                     CHECK_ERROR_MSG_6 },
+  { lexer::TOKEN_INST_32IM_MD_REMU,    1, { FORM_RRR },                     CHECK_ERROR_MSG_6 },
+  { lexer::TOKEN_INST_32IM_CP_SLT,     1, { FORM_RRR },                     CHECK_ERROR_MSG_6 },
+  { lexer::TOKEN_INST_32IM_CP_SLTU,    1, { FORM_RRR },                     CHECK_ERROR_MSG_6 },
+  { lexer::TOKEN_INST_32IM_LNS_ADD,    1, { FORM_RRR },                     CHECK_ERROR_MSG_6 },
+  { lexer::TOKEN_INST_32IM_LNS_SUB,    1, { FORM_RRR },                     CHECK_ERROR_MSG_6 },
+  { lexer::TOKEN_INST_32IM_LNS_MUL,    1, { FORM_RRR },                     CHECK_ERROR_MSG_6 },
+  { lexer::TOKEN_INST_32IM_LNS_DIV,    1, { FORM_RRR },                     CHECK_ERROR_MSG_6 },
+
+  { lexer::TOKEN_INST_32IM_LS_LB,      2, { FORM_RM, FORM_RS },             CHECK_ERROR_MSG_LS },
+  { lexer::TOKEN_INST_32IM_LS_LH,      2, { FORM_RM, FORM_RS },             CHECK_ERROR_MSG_LS },
+  { lexer::TOKEN_INST_32IM_LS_LW,      2, { FORM_RM, FORM_RS },             CHECK_ERROR_MSG_LS },
+  { lexer::TOKEN_INST_32IM_LS_LBU,     2, { FORM_RM, FORM_RS },             CHECK_ERROR_MSG_LS },
+  { lexer::TOKEN_INST_32IM_LS_LHU,     2, { FORM_RM, FORM_RS },             CHECK_ERROR_MSG_LS },
+  { lexer::TOKEN_INST_32IM_LS_SB,      2, { FORM_RM_STORE, FORM_RS_STORE }, CHECK_ERROR_MSG_LS },
+  { lexer::TOKEN_INST_32IM_LS_SH,      2, { FORM_RM_STORE, FORM_RS_STORE }, CHECK_ERROR_MSG_LS },
+  { lexer::TOKEN_INST_32IM_LS_SW,      2, { FORM_RM_STORE, FORM_RS_STORE }, CHECK_ERROR_MSG_LS },
+};
+
+inline constexpr uint32_t PARSER_S_INST_RULES = sizeof(PARSER_INST_RULES) / sizeof(ParserInstRule);
+
+// rules indexed by token type, a type without forms is not an instruction
+typedef struct parser_inst_table {
+  ParserInstRule rules[lexer::TOKEN_INST_32IM_MAX];
+} ParserInstTable;
+
+constexpr ParserInstTable _parser_inst_table_build() {
+  ParserInstTable table = {};
+  for (uint32_t i = 0; i < PARSER_S_INST_RULES; i++)
+    table.rules[PARSER_INST_RULES[i].type] = PARSER_INST_RULES[i];
+  return table;
+}
+
+inline constexpr ParserInstTable PARSER_INST_TABLE = _parser_inst_table_build();
+
+constexpr bool _parser_inst_table_complete() {
+  for (uint32_t type = lexer::TOKEN_INST_32IM_NOP; type < lexer::TOKEN_INST_32IM_MAX; type++) {
+    if (PARSER_INST_TABLE.rules[type].s_forms == 0)
+      return false;
+  }
+  return true;
+}
+
+static_assert(_parser_inst_table_complete(), "parser - every instruction token needs a rule in PARSER_INST_RULES");
+
+// where parsing stands between two ranges of tokens, parse hands the whole
+// stream over at once and parse_stream one batch at a time
+typedef struct parser_state {
+  lexer::RISCVTokenType section; // TOKEN_NONE until the first section starts
+  bool     text; // .text was entered, it ends the file when it comes second
+  bool     done;
+  uint32_t s_threads; // .text is parsed on this many threads when it is large enough
+  uint64_t max_s_chunks, max_s_data;
+} ParserState;
+
+#define PARSER_STATE_INIT ((ParserState){ \
+  .section      = lexer::TOKEN_NONE, \
+  .text         = false, \
+  .done         = false, \
+  .s_threads    = 1, \
+  .max_s_chunks = 1 << 2, \
+  .max_s_data   = 1 << 3 \
+})
+
+parser::RISCVAST* _parser_ast_create (const lexer::RISCVTokenStream*, const uint64_t);
+
+void _parser_parse_range   (parser::RISCVAST*, ParserState&, const lexer::RISCVTokenStream*, uint64_t&, const uint64_t);
+void _parser_enter_section (parser::RISCVAST*, ParserState&, const lexer::RISCVTokenType);
+void _parser_parse_text    (parser::RISCVAST*, uint64_t&, const lexer::RISCVTokenStream*, uint64_t&, const uint64_t);
+void _parser_parse_data    (parser::RISCVAST*, uint64_t&, const lexer::RISCVTokenStream*, uint64_t&, const uint64_t);
+
+uint64_t _parser_text_match    (const lexer::RISCVTokenStream*, const uint64_t, parser::RISCVASTN_Text&);
+uint64_t _parser_text_report   (parser::RISCVAST*, const lexer::RISCVTokenStream*, const uint64_t);
+uint8_t  _parser_operand_class (const lexer::RISCVTokenType);
+uint64_t _parser_form_match    (const lexer::RISCVTokenStream*, const uint64_t, const ParserForm&, uint16_t&);
+uint64_t _parser_skip_statement(const lexer::RISCVTokenStream*, uint64_t);
+void     _parser_text_push     (parser::RISCVAST*, uint64_t&, const parser::RISCVASTN_Text);
+void     _parser_text_append   (parser::RISCVAST*, uint64_t&, const parser::RISCVASTN_Text*, const uint64_t);
+void     _parser_check_width   (parser::RISCVAST*, const lexer::RISCVTokenStream*, const uint64_t, const uint64_t);
+void     _parser_symbols_note  (parser::RISCVAST*, const lexer::RISCVTokenStream*, const uint64_t, const uint64_t);
+void     _parser_symbols_check (parser::RISCVAST*);
+
+#define PARSER_MIN_S_PART (1 << 16) // tokens, a thread is not worth it for fewer
+
+// a slice of .text that starts on a label, so that no statement is split, and
+// that one thread parses on its own; the thread stops quietly on the first
+// statement that does not parse, which is then parsed again in order on the
+// calling thread so that diagnostics come out as parse reports them
+typedef struct parser_part {
+  uint64_t                 begin, end;
+  uint64_t                 stop; // first statement not parsed, end if there is none
+  parser::RISCVASTN_Text*  nodes;
+  uint64_t                 s_nodes, max_s_nodes;
+} ParserPart;
+
+uint32_t _parser_parts_split         (ParserPart*, const uint32_t, const lexer::RISCVTokenStream*, const uint64_t, const uint64_t);
+void     _parser_part_parse          (ParserPart*, const lexer::RISCVTokenStream*);
+void     _parser_parse_text_parallel (parser::RISCVAST*, ParserState&, const lexer::RISCVTokenStream*, uint64_t&, const uint64_t);
+
+#define PARSER_S_BATCH (1 << 14) // tokens the lexer thread hands over at a time
+#define PARSER_S_QUEUE 4         // batches lexed ahead of the parser at most
+
+// a copy of what the streaming lexer produced, source included, since its
+// window has moved on by the time the batch is parsed; strings are the
+// entries the lexer thread added to the string table while lexing it
+typedef struct parser_batch {
+  lexer::RISCVTokenStream* tokens;
+  struct lexer::riscv_strtab::riscv_strtab_entry* strings;
+  uint32_t s_strings, max_s_strings;
+} ParserBatch;
+
+// a ring of batches, the lexer thread fills the s_batches slots after head
+// and the parser empties them from head
+typedef struct parser_queue {
+  ParserBatch             batches[PARSER_S_QUEUE];
+  uint32_t                head, s_batches;
+  bool                    ended; // the lexer pushed its last batch
+  std::mutex              mutex;
+  std::condition_variable cond;
+} ParserQueue;
+
+void     _parser_stream_lex      (ParserQueue*, const char*, lexer::RISCVStrTab*);
+uint64_t _parser_stream_boundary (const lexer::RISCVTokenStream*);
+void     _parser_stream_parse    (parser::RISCVAST*, ParserState&, lexer::RISCVTokenStream*, const uint64_t, lexer::RISCVTokenStream*);
 
-void _parser_parse_text (parser::RISCVAST**, uint64_t&, lexer::RISCVToken*, const uint64_t, uint64_t&);
-void _parser_parse_data (parser::RISCVAST*, uint64_t&, lexer::RISCVToken*, const uint64_t, uint64_t&);
+parser::RISCVIR_Inst _parser_lower_inst(const lexer::RISCVTokenStream*, const parser::RISCVASTN_Text*);
 
 #endif // !__PARSER_PRIVATE_H__
@@ -0,0 +1,81 @@
+#include "parser_private.hpp"
+
+namespace parser {
+  RISCVIR* lower(const RISCVAST* ast) {
+    error(FATAL, ast == nullptr, "parser - ast is a nullptr in ", __FUNCTION__, __FILE__, __LINE__);
+    const lexer::RISCVTokenStream* tokens = ast->tokens;
+
+    RISCVIR* ir = (RISCVIR*)malloc(sizeof(struct riscv_ir));
+    error(FATAL, ir == nullptr, "parser - allocation of RISCVIR* returned a nullptr", "", __FILE__, __LINE__);
+    ir->s_insts   = ast->s_text;
+    ir->s_data    = ast->s_data;
+    ir->s_symbols = ast->s_symbols;
+    ir->insts     = (RISCVIR_Inst*)malloc((ir->s_insts > 0 ? ir->s_insts : 1) * sizeof(struct riscv_ir_inst));
+    ir->data      = (RISCVIR_Data*)malloc((ir->s_data > 0 ? ir->s_data : 1) * sizeof(struct riscv_ir_data));
+    error(FATAL, ir->insts == nullptr || ir->data == nullptr, "parser - allocation of the lowered program returned a nullptr", "", __FILE__, __LINE__);
+
+    for (uint64_t i = 0; i < ast->s_text; i++)
+      ir->insts[i] = _parser_lower_inst(tokens, ast_get_text(ast, i));
+
+    for (uint64_t i = 0; i < ast->s_data; i++) {
+      ir->data[i] = (RISCVIR_Data){
+        .symbol = lexer::riscv_tokens_get_id(tokens, ast->data[i].symbol),
+        .size   = ast_data_size(ast, &ast->data[i])
+      };
+    }
+
+    trace(TRACE_PARSER, "parser - lowered instructions: ", ir->s_insts, __FILE__, __LINE__);
+    return ir;
+  }
+
+  void ir_free(RISCVIR* ir) {
+    if (ir == nullptr)
+      return;
+
+    free(ir->insts);
+    free(ir->data);
+    free(ir);
+  }
+}
+
+parser::RISCVIR_Inst _parser_lower_inst(const lexer::RISCVTokenStream* tokens, const parser::RISCVASTN_Text* node) {
+  const lexer::RISCVTokenType type = lexer::riscv_tokens_get_type(tokens, node->inst);
+  parser::RISCVIR_Inst inst = {
+    .op     = (uint8_t)type,
+    .rd     = IR_REG_NONE,
+    .rs1    = IR_REG_NONE,
+    .rs2    = IR_REG_NONE,
+    .imm    = 0,
+    .symbol = IR_SYMBOL_NONE
+  };
+
+  if (type == lexer::TOKEN_SYMBOL) {
+    inst.op     = IR_OP_LABEL;
+    inst.symbol = lexer::riscv_tokens_get_id(tokens, node->inst);
+    return inst;
+  }
+
+  // the form the parser matched says what each operand is, registers were
+  // checked against it already and need no domain check here
+  const ParserForm* form = &PARSER_INST_TABLE.rules[type].forms[node->form];
+  for (uint32_t k = 0; k < form->s_operands; k++) {
+    const uint32_t field = parser::ast_get_field(node, k + 1);
+    const lexer::RISCVTokenType operand = lexer::riscv_tokens_get_type(tokens, field);
+    const uint8_t reg = (uint8_t)(operand - lexer::TOKEN_REG_X0);
+
+    switch (form->roles[k]) {
+      case ROLE_RD:  { inst.rd  = reg; break; }
+      case ROLE_RS1: { inst.rs1 = reg; break; }
+      case ROLE_RS2: { inst.rs2 = reg; break; }
+      default: {
+        if (operand == lexer::TOKEN_SYMBOL)
+          inst.symbol = lexer::riscv_tokens_get_id(tokens, field);
+        else
+          inst.imm = lexer::riscv_tokens_get_number(tokens, field);
+        break;
+      }
+    }
+  }
+
+  return inst;
+}
@@ -1,337 +1,46 @@
 #include "parser_private.hpp"
 
 namespace parser {
-  RISCVAST* parse(lexer::RISCVToken* tokens, const uint64_t s_tokens) {
-    error(FATAL, tokens == nullptr, "parser - tokens is a nullptr", "", __FILE__, __LINE__);
+  RISCVAST* parse(const lexer::RISCVTokenStream* tokens) {
+    error(FATAL, tokens == nullptr || tokens->s_tokens == 0, "parser - tokens is a nullptr", "", __FILE__, __LINE__);
 
-    uint64_t
-      max_s_text = 1 << 5,
-      max_s_data = 1 << 3;
-
-    RISCVAST* ast = (RISCVAST*)malloc(sizeof(struct riscv_ast) + max_s_text * sizeof(struct riscv_astn_text));
-    error(FATAL, ast == nullptr, "parser - allocation of RISCVAST* returned a nullptr", "", __FILE__, __LINE__);
-    ast->data  = nullptr;
-    ast->error = false;
-    ast->s_text = ast->s_data = 0;
-    log("parser - initialized ast", "", __FILE__, __LINE__);
+    ParserState state = PARSER_STATE_INIT;
+    RISCVAST* ast = _parser_ast_create(tokens, state.max_s_chunks);
+    ast->error = tokens->error;
 
     uint64_t i = 0;
-    if (tokens[i].type == lexer::TOKEN_TEXT) {
-      _parser_parse_text(&ast, max_s_text, tokens, s_tokens, i);
-      _parser_parse_data(ast, max_s_data, tokens, s_tokens, i);
-    } else if (tokens[i].type == lexer::TOKEN_DATA) {
-      _parser_parse_data(ast, max_s_data, tokens, s_tokens, i);
-      _parser_parse_text(&ast, max_s_text, tokens, s_tokens, i);
-    } else {
-      error(
-        FATAL, 
-        true,
-        "parser - grammatical structure of assembly is incorrect: missing/miss placed .text symbol",
-        "",
-        tokens[i].filename,
-        tokens[i].line
-      );
-    }
+    _parser_parse_range(ast, state, tokens, i, tokens->s_tokens);
+    _parser_symbols_note(ast, tokens, 0, 0);
+    _parser_symbols_check(ast);
     
-    log("parser - returning ast", "", __FILE__, __LINE__);
+    trace(TRACE_PARSER, "parser - returning ast", "", __FILE__, __LINE__);
     return ast;
   }
 
-  void check(RISCVAST* ast) {
-    for (uint64_t i = 0; i < ast->s_text; i++) {
-      const RISCVASTN_Text* cmd = &(ast->text[i]);
-
-      switch (cmd->inst->type) {
-        case lexer::TOKEN_INST_32IM_FC_J: {
-          const bool error = cmd->f1->type != lexer::TOKEN_SYMBOL;
-          ast->error |= error;
-          error(
-            ERROR,
-            error,
-            CHECK_ERROR_MSG_J,
-            lexer::riscv_token_get_type_string(lexer::TOKEN_INST_32IM_FC_J),
-            cmd->inst->filename,
-            cmd->inst->line
-          );
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_FC_JR:
-        case lexer::TOKEN_INST_32IM_FC_CALL: {
-          const bool error = !lexer::riscv_token_is_reg(cmd->f1->type);
-          ast->error |= error;
-          error(
-            ERROR,
-            error,
-            CHECK_ERROR_MSG_JR_CALL,
-            lexer::riscv_token_get_type_string(cmd->inst->type),
-            cmd->inst->filename,
-            cmd->inst->line
-          );
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_FC_JAL: {
-          const bool error = !(
-            (
-              lexer::riscv_token_is_reg(cmd->f1->type) &&
-              cmd->f2->type == lexer::TOKEN_LIT_NUMBER
-            ) || (
-              cmd->f1->type == lexer::TOKEN_SYMBOL &&
-              cmd->f2 == nullptr
-            )
-          );
-          ast->error |= error;
-          error(
-            ERROR,
-            error,
-            CHECK_ERROR_MSG_JAL,
-            lexer::riscv_token_get_type_string(lexer::TOKEN_INST_32IM_FC_JAL),
-            cmd->inst->filename,
-            cmd->inst->line
-          );
-          break;
-        }
-        case lexer::TOKEN_INST_32IM_FC_JALR: {
-          const bool error = !(
-            lexer::riscv_token_is_reg(cmd->f1->type) &&
-            (
-              cmd->f2 == nullptr || 
-              (lexer::riscv_token_is_reg(cmd->f2->type) && cmd->f3->type == lexer::TOKEN_LIT_NUMBER)
-            )
-          );
-          ast->error |= error;
-          error(
-            ERROR,
-            error,
-            CHECK_ERROR_MSG_JALR,
-            lexer::riscv_token_get_type_string(lexer::TOKEN_INST_32IM_FC_JALR),
-            cmd->inst->filename,
-            cmd->inst->line
-          );
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_MOVE_LI:
-        case lexer::TOKEN_INST_32IM_MOVE_LUI:
-        case lexer::TOKEN_INST_32IM_MOVE_AUIPC: {
-          const bool error = !(
-            lexer::riscv_token_is_reg(cmd->f1->type) &&
-            cmd->f2->type == lexer::TOKEN_LIT_NUMBER
-          );
-          ast->error |= error;
-          error(
-            ERROR,
-            error,
-            CHECK_ERROR_MSG_1,
-            lexer::riscv_token_get_type_string(cmd->inst->type),
-            cmd->inst->filename,
-            cmd->inst->line
-          );
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_MOVE_LA: 
-        case lexer::TOKEN_INST_32IM_FC_BEQZ:
-        case lexer::TOKEN_INST_32IM_FC_BNEZ:
-        case lexer::TOKEN_INST_32IM_FC_BLEZ:
-        case lexer::TOKEN_INST_32IM_FC_BGEZ:
-        case lexer::TOKEN_INST_32IM_FC_BLTZ:
-        case lexer::TOKEN_INST_32IM_FC_BGTZ: {
-          const bool error = !(
-            lexer::riscv_token_is_reg(cmd->f1->type) &&
-            cmd->f2->type == lexer::TOKEN_SYMBOL
-          );
-          ast->error |= error;
-          error(
-            ERROR,
-            error,
-            CHECK_ERROR_MSG_2,
-            lexer::riscv_token_get_type_string(cmd->inst->type),
-            cmd->inst->filename,
-            cmd->inst->line
-          );
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_MOVE_MV:
-        case lexer::TOKEN_INST_32IM_ALS_NEG:
-        case lexer::TOKEN_INST_32IM_ALS_NOT: 
-        case lexer::TOKEN_INST_32IM_CP_SEQZ:
-        case lexer::TOKEN_INST_32IM_CP_SNEZ:
-        case lexer::TOKEN_INST_32IM_CP_SLTZ:
-        case lexer::TOKEN_INST_32IM_CP_SGTZ:
-        case lexer::TOKEN_INST_32IM_LNS_SQT: {
-          const bool error = !(
-            lexer::riscv_token_is_reg(cmd->f1->type) &&
-            lexer::riscv_token_is_reg(cmd->f2->type)
-          );
-          ast->error |= error;
-          error(
-            ERROR,
-            error,
-            CHECK_ERROR_MSG_3,
-            lexer::riscv_token_get_type_string(cmd->inst->type),
-            cmd->inst->filename,
-            cmd->inst->line
-          );
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_FC_BGT:
-        case lexer::TOKEN_INST_32IM_FC_BLE:
-        case lexer::TOKEN_INST_32IM_FC_BGTU:
-        case lexer::TOKEN_INST_32IM_FC_BLEU: {
-          const bool error = !(
-            lexer::riscv_token_is_reg(cmd->f1->type) &&
-            lexer::riscv_token_is_reg(cmd->f2->type) &&
-            cmd->f3->type == lexer::TOKEN_SYMBOL
-          );
-          ast->error |= error;
-          error(
-            ERROR,
-            error,
-            CHECK_ERROR_MSG_4,
-            lexer::riscv_token_get_type_string(cmd->inst->type),
-            cmd->inst->filename,
-            cmd->inst->line
-          );
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_ALS_ADDI:
-        case lexer::TOKEN_INST_32IM_ALS_ANDI:
-        case lexer::TOKEN_INST_32IM_ALS_ORI:
-        case lexer::TOKEN_INST_32IM_ALS_XORI:
-        case lexer::TOKEN_INST_32IM_ALS_SLLI:
-        case lexer::TOKEN_INST_32IM_ALS_SRLI:
-        case lexer::TOKEN_INST_32IM_ALS_SRAI:
-        case lexer::TOKEN_INST_32IM_CP_SLTI:
-        case lexer::TOKEN_INST_32IM_CP_SLTIU:
-        case lexer::TOKEN_INST_32IM_FC_BEQ:
-        case lexer::TOKEN_INST_32IM_FC_BNE:
-        case lexer::TOKEN_INST_32IM_FC_BGE:
-        case lexer::TOKEN_INST_32IM_FC_BLT:
-        case lexer::TOKEN_INST_32IM_FC_BGEU:
-        case lexer::TOKEN_INST_32IM_FC_BLTU: {
-          const bool error = !(
-            lexer::riscv_token_is_reg(cmd->f1->type) &&
-            lexer::riscv_token_is_reg(cmd->f2->type) &&
-            cmd->f3->type == lexer::TOKEN_LIT_NUMBER
-          );
-          ast->error |= error;
-          error(
-            ERROR,
-            error,
-            CHECK_ERROR_MSG_5,
-            lexer::riscv_token_get_type_string(cmd->inst->type),
-            cmd->inst->filename,
-            cmd->inst->line
-          );
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_ALS_ADD:
-        case lexer::TOKEN_INST_32IM_ALS_SUB:
-        case lexer::TOKEN_INST_32IM_ALS_AND:
-        case lexer::TOKEN_INST_32IM_ALS_OR:
-        case lexer::TOKEN_INST_32IM_ALS_XOR:
-        case lexer::TOKEN_INST_32IM_ALS_SLL:
-        case lexer::TOKEN_INST_32IM_ALS_SRL:
-        case lexer::TOKEN_INST_32IM_ALS_SRA:
-        case lexer::TOKEN_INST_32IM_MD_MUL:
-        case lexer::TOKEN_INST_32IM_MD_MULH:
-        case lexer::TOKEN_INST_32IM_MD_MULSU:
-        case lexer::TOKEN_INST_32IM_MD_MULU:
-        case lexer::TOKEN_INST_32IM_MD_DIV:
-        case lexer::TOKEN_INST_32IM_MD_DIVU:
-        case lexer::TOKEN_INST_32IM_MD_REM:
-        case lexer::TOKEN_INST_32IM_MD_REMU:
-        case lexer::TOKEN_INST_32IM_CP_SLT:
-        case lexer::TOKEN_INST_32IM_CP_SLTU:
-        case lexer::TOKEN_INST_32IM_LNS_ADD:
-        case lexer::TOKEN_INST_32IM_LNS_SUB:
-        case lexer::TOKEN_INST_32IM_LNS_MUL:
-        case lexer::TOKEN_INST_32IM_LNS_DIV: {
-          const bool error = !(
-            lexer::riscv_token_is_reg(cmd->f1->type) &&
-            lexer::riscv_token_is_reg(cmd->f2->type) &&
-            lexer::riscv_token_is_reg(cmd->f3->type)
-          );
-          ast->error |= error;
-          error(
-            ERROR,
-            error,
-            CHECK_ERROR_MSG_6,
-            lexer::riscv_token_get_type_string(cmd->inst->type),
-            cmd->inst->filename,
-            cmd->inst->line
-          );
-          break;
-        }
-
-        case lexer::TOKEN_INST_32IM_LS_LB:
-        case lexer::TOKEN_INST_32IM_LS_LH:
-        case lexer::TOKEN_INST_32IM_LS_LW:
-        case lexer::TOKEN_INST_32IM_LS_LBU:
-        case lexer::TOKEN_INST_32IM_LS_LHU:
-        case lexer::TOKEN_INST_32IM_LS_SB:
-        case lexer::TOKEN_INST_32IM_LS_SH:
-        case lexer::TOKEN_INST_32IM_LS_SW: {
-          const bool error = !(
-            (
-              lexer::riscv_token_is_reg(cmd->f1->type) &&
-              cmd->f2->type == lexer::TOKEN_SYMBOL &&
-              cmd->f3 == nullptr
-            ) || (
-              lexer::riscv_token_is_reg(cmd->f1->type) &&
-              cmd->f2->type == lexer::TOKEN_LIT_NUMBER &&
-              lexer::riscv_token_is_reg(cmd->f3->type)
-            ) || (
-              lexer::riscv_token_is_reg(cmd->f1->type) &&
-              cmd->f2->type == lexer::TOKEN_SYMBOL &&
-              lexer::riscv_token_is_reg(cmd->f3->type)
-            )
-          );
-          ast->error |= error;
-          error(
-            ERROR,
-            error,
-            CHECK_ERROR_MSG_LS,
-            lexer::riscv_token_get_type_string(cmd->inst->type),
-            cmd->inst->filename,
-            cmd->inst->line
-          );
-          break;
-        }
-
-        default: {
-          break;
-        }
-      }
-    }
-  }
-
   void ast_print(const RISCVAST* ast) {
     if (ast == nullptr)
       return;
     
+    const lexer::RISCVTokenStream* tokens = ast->tokens;
     std::cout << "AST {" << std::endl;
 
     std::cout << (ast->s_data > 0 ? "  Data {" : "") << std::endl;
     for (uint64_t i = 0; i < ast->s_data; i++) {
       std::cout 
-        << "    Symbol: " << ast->data[i].symbol->lit.string << ", \n"
-        << "      Type: " << lexer::riscv_token_get_type_string(ast->data[i].type->type) << ", \n"
+        << "    Symbol: " << lexer::riscv_tokens_get_string(tokens, ast->data[i].symbol) << ", \n"
+        << "      Type: " << lexer::riscv_token_get_type_string(lexer::riscv_tokens_get_type(tokens, ast->data[i].type)) << ", \n"
         << "      Values: (";
 
-      for (uint64_t j = 0; j < ast->data[i].s_arr; j++) {
-        if (ast->data[i].arr[j]->type == lexer::TOKEN_LIT_NUMBER) {
-          std::cout << ast->data[i].arr[j]->lit.number;
+      for (uint64_t j = 0; j < ast->data[i].s_lits; j++) {
+        const uint32_t lit = ast_get_lit(&ast->data[i], j);
+        if (lexer::riscv_tokens_get_type(tokens, lit) == lexer::TOKEN_LIT_NUMBER) {
+          std::cout << lexer::riscv_tokens_get_number(tokens, lit);
+        } else if (lexer::riscv_tokens_get_type(tokens, lit) == lexer::TOKEN_LIT_STRING) {
+          lexer::riscv_tokens_print_string(tokens, lit);
         } else {
-          std::cout << ast->data[i].arr[j]->lit.string;
+          std::cout << lexer::riscv_tokens_get_string(tokens, lit);
         }
-        std::cout << (j < ast->data->s_arr - 1 ? ", " : "");
+        std::cout << (j + 1 < ast->data[i].s_lits ? ", " : "");
       }
       std::cout << ")" << std::endl;
     }
@@ -340,62 +49,26 @@ namespace parser {
     error(FATAL, ast->text == nullptr, "parser - ast->text is a nullptr", "", __FILE__, __LINE__);
     std::cout << "  Text {" << std::endl;
     for (uint64_t i = 0; i < ast->s_text; i++) {
-      std::cout << "    Inst: " << lexer::riscv_token_get_type_string(ast->text[i].inst->type) << "\n";
-
-      if (ast->text[i].f1 == nullptr)
-        continue;
-
-      std::cout << "      f1: " << lexer::riscv_token_get_type_string(ast->text[i].f1->type) << "\n";
-
-      if (ast->text[i].f2 == nullptr)
-        continue;
-
-      lexer::RISCVTokenType type = ast->text[i].f2->type;
-      bool not_lit_or_symbol = !lexer::riscv_token_is_lit(type) && type != lexer::TOKEN_SYMBOL;
-      char* str = type == lexer::TOKEN_LIT_STRING || type == lexer::TOKEN_SYMBOL ? ast->text[i].f2->lit.string : nullptr;
-      int32_t number = type == lexer::TOKEN_LIT_NUMBER ? ast->text[i].f2->lit.number : 0;
-
-      std::cout << "      f2: ";
-      if (not_lit_or_symbol) {
-        std::cout << lexer::riscv_token_get_type_string(type) << "\n";
-      } else if (str != nullptr) {
-        std::cout << str << "\n";
-      } else {
-        std::cout << number << "\n";
-      }
+      const RISCVASTN_Text* node = ast_get_text(ast, i);
+      std::cout << "    Inst: " << lexer::riscv_token_get_type_string(lexer::riscv_tokens_get_type(tokens, node->inst)) << "\n";
 
-      if (ast->text[i].f3 == nullptr)
-        continue;
-
-      type = ast->text[i].f3->type;
-      not_lit_or_symbol = !lexer::riscv_token_is_lit(type) && type != lexer::TOKEN_SYMBOL;
-      str = type == lexer::TOKEN_LIT_STRING || type == lexer::TOKEN_SYMBOL ? ast->text[i].f3->lit.string : nullptr;
-      number = type == lexer::TOKEN_LIT_NUMBER ? ast->text[i].f3->lit.number : 0;
-
-      std::cout << "      f3: ";
-      if (not_lit_or_symbol) {
-        std::cout << lexer::riscv_token_get_type_string(type) << "\n";
-      } else if (str != nullptr) {
-        std::cout << str << "\n";
-      } else {
-        std::cout << number << "\n";
-      }
-
-      if (ast->text[i].f4 == nullptr)
-        continue;
+      for (uint32_t k = 1; k <= AST_S_FIELDS; k++) {
+        const uint32_t field = ast_get_field(node, k);
+        if (field == AST_TOKEN_NONE)
+          break;
 
-      type = ast->text[i].f4->type;
-      not_lit_or_symbol = !lexer::riscv_token_is_lit(type) && type != lexer::TOKEN_SYMBOL;
-      str = type == lexer::TOKEN_LIT_STRING || type == lexer::TOKEN_SYMBOL ? ast->text[i].f4->lit.string : nullptr;
-      number = type == lexer::TOKEN_LIT_NUMBER ? ast->text[i].f4->lit.number : 0;
-
-      std::cout << "      f4: ";
-      if (not_lit_or_symbol) {
-        std::cout << lexer::riscv_token_get_type_string(type) << "\n";
-      } else if (str != nullptr) {
-        std::cout << str << "\n";
-      } else {
-        std::cout << number << "\n";
+        const lexer::RISCVTokenType type = lexer::riscv_tokens_get_type(tokens, field);
+        std::cout << "      f" << k << ": ";
+        if (k == 1 || (!lexer::riscv_token_is_lit(type) && type != lexer::TOKEN_SYMBOL)) {
+          std::cout << lexer::riscv_token_get_type_string(type);
+        } else if (type == lexer::TOKEN_SYMBOL) {
+          std::cout << lexer::riscv_tokens_get_string(tokens, field);
+        } else if (type == lexer::TOKEN_LIT_STRING) {
+          lexer::riscv_tokens_print_string(tokens, field);
+        } else {
+          std::cout << lexer::riscv_tokens_get_number(tokens, field);
+        }
+        std::cout << "\n";
       }
     }
     std::cout << "  }" << std::endl;
@@ -406,404 +79,270 @@ namespace parser {
     if (ast == nullptr)
       return;
     
-    if (ast->data != nullptr) {
-      for (uint64_t i = 0; i < ast->s_data; i++) {
-        if (ast->data[i].arr != nullptr)
-          free(ast->data[i].arr);
-      }
+    if (ast->data != nullptr)
       free(ast->data);
-    }
 
+    for (uint64_t c = 0; c < ast->s_chunks; c++)
+      free(ast->text[c]);
+    free(ast->text);
+    free(ast->defined);
+    free(ast->referenced);
+    free(ast->refs);
     free(ast);
   }
+
+  uint32_t ast_data_size(const RISCVAST* ast, const RISCVASTN_Data* node) {
+    const lexer::RISCVTokenStream* tokens = ast->tokens;
+    const lexer::RISCVTokenType type = lexer::riscv_tokens_get_type(tokens, node->type);
+    if (type != lexer::TOKEN_STRING)
+      return lexer::riscv_token_get_type_size(type) * node->s_lits;
+
+    // strings are stored NUL terminated
+    uint64_t s_data = 0;
+    for (uint64_t j = 0; j < node->s_lits; j++)
+      s_data += lexer::riscv_tokens_get_string_size(tokens, ast_get_lit(node, j)) + 1;
+    return (uint32_t)s_data;
+  }
 }
 
-void _parser_parse_text(
-  parser::RISCVAST** ast, uint64_t& max_s_text,
-  lexer::RISCVToken* tokens, const uint64_t s_tokens, uint64_t& i
+parser::RISCVAST* _parser_ast_create(const lexer::RISCVTokenStream* tokens, const uint64_t max_s_chunks) {
+  parser::RISCVAST* ast = (parser::RISCVAST*)malloc(sizeof(struct parser::riscv_ast));
+  error(FATAL, ast == nullptr, "parser - allocation of RISCVAST* returned a nullptr", "", __FILE__, __LINE__);
+  ast->text = (parser::RISCVASTN_Text**)malloc(max_s_chunks * sizeof(parser::RISCVASTN_Text*));
+  error(FATAL, ast->text == nullptr, "parser - allocation of text chunks returned a nullptr", "", __FILE__, __LINE__);
+  ast->data    = nullptr;
+  ast->defined = ast->referenced = nullptr;
+  ast->refs    = nullptr;
+  ast->tokens  = tokens;
+  ast->error   = false;
+  ast->s_text  = ast->s_data = ast->s_chunks = 0;
+  ast->s_symbols = ast->max_s_symbols = 0;
+  ast->s_refs    = ast->max_s_refs    = 0;
+  trace(TRACE_PARSER, "parser - initialized ast", "", __FILE__, __LINE__);
+  return ast;
+}
+
+void _parser_parse_range(
+  parser::RISCVAST* ast, ParserState& state,
+  const lexer::RISCVTokenStream* tokens, uint64_t& i, const uint64_t end
 ) {
-  error(
-    FATAL, 
-    tokens[i].type != lexer::TOKEN_TEXT,
-    "parser - grammatical structure of assembly is incorrect: missing .text symbol",
-    "",
-    tokens[i].filename,
-    tokens[i].line
-  );
+  // a file is one .text and one .data section in either order, whatever
+  // follows the second of them is not looked at
+  while (i < end && !state.done) {
+    const lexer::RISCVTokenType type = lexer::riscv_tokens_get_type(tokens, i);
+    if (state.section == lexer::TOKEN_NONE) {
+      error(
+        FATAL, 
+        type != lexer::TOKEN_TEXT && type != lexer::TOKEN_DATA,
+        "parser - grammatical structure of assembly is incorrect: missing/miss placed .text symbol",
+        "",
+        tokens->filename,
+        lexer::riscv_tokens_get_line(tokens, i)
+      );
+      _parser_enter_section(ast, state, type);
+      i++;
+    } else if (state.section == lexer::TOKEN_TEXT) {
+      if (state.s_threads > 1)
+        _parser_parse_text_parallel(ast, state, tokens, i, end);
+      else
+        _parser_parse_text(ast, state.max_s_chunks, tokens, i, end);
+      if (i < end) {
+        error(FATAL, ast->data != nullptr, "parser - already parsed .data section", "", tokens->filename, lexer::riscv_tokens_get_line(tokens, i));
+        _parser_enter_section(ast, state, lexer::TOKEN_DATA);
+        i++;
+      }
+    } else {
+      _parser_parse_data(ast, state.max_s_data, tokens, i, end);
+      if (i < end && state.text) {
+        state.done = true;
+      } else if (i < end) {
+        _parser_enter_section(ast, state, lexer::TOKEN_TEXT);
+        i++;
+      }
+    }
+  }
+}
 
-  parser::RISCVAST* _ast = *ast;
-  log("parser - parsing .text", "", __FILE__, __LINE__);
+void _parser_enter_section(parser::RISCVAST* ast, ParserState& state, const lexer::RISCVTokenType section) {
+  state.section = section;
+  if (section == lexer::TOKEN_TEXT) {
+    state.text = true;
+    trace(TRACE_PARSER, "parser - parsing .text", "", __FILE__, __LINE__);
+    return;
+  }
 
-  i++;
-  for (uint64_t incr = 0; i < s_tokens; i += incr) {
-    if (tokens[i].type == lexer::TOKEN_DATA) {
-      error(FATAL, _ast->data != nullptr, "parser - already parsed .data section", "", tokens[i].filename, tokens[i].line);
-      return;
-    }
+  ast->data = (parser::RISCVASTN_Data*)malloc(state.max_s_data * sizeof(parser::riscv_astn_data));
+  error(FATAL, ast->data == nullptr, "parser - allocation of RISCVASTN_Data* returned a nullptr", "", __FILE__, __LINE__);
+  trace(TRACE_PARSER, "parser - parsing .data", "", __FILE__, __LINE__);
+}
 
-    if (_ast->s_text >= max_s_text) {
-      max_s_text <<= 1;
-      _ast = (parser::RISCVAST*)realloc(_ast, sizeof(parser::riscv_ast) + max_s_text * sizeof(parser::riscv_astn_text));
-      error(FATAL, _ast == nullptr, "parser - reallocation of RISCVAST* returned a nullptr", "", __FILE__, __LINE__);
-      log("parser - reallocated text array", "", __FILE__, __LINE__);
+void _parser_parse_text(
+  parser::RISCVAST* ast, uint64_t& max_s_chunks,
+  const lexer::RISCVTokenStream* tokens, uint64_t& i, const uint64_t end
+) {
+  // stops on the .data that ends the section, or at end
+  while (i < end && lexer::riscv_tokens_get_type(tokens, i) != lexer::TOKEN_DATA) {
+    parser::RISCVASTN_Text node;
+    const uint64_t s_match = _parser_text_match(tokens, i, node);
+    if (s_match == 0) {
+      i = _parser_text_report(ast, tokens, i);
+      continue;
     }
 
-    incr = 1;
-    switch (tokens[i].type) {
-      case lexer::TOKEN_SYMBOL: {
-        _ast->error |= i + 1 >= s_tokens || tokens[i + 1].type != lexer::TOKEN_COLON;
-        error(
-          FATAL, 
-          _ast->error,
-          "parser - following character is missing \":\": ",
-          tokens[i].lit.string,
-          tokens[i].filename,
-          tokens[i].line
-        );
-
-        if (!_ast->error) {
-          _ast->text[_ast->s_text++] = (parser::RISCVASTN_Text){
-            .inst   = &(tokens[i]),
-            .f1     = nullptr,
-            .f2     = nullptr,
-            .f3     = nullptr,
-            .f4     = nullptr
-          };
-          incr = 2;
-          log("parser - parsed TOKEN_SYMBOL rule ", tokens[i].lit.string, tokens[i].filename, tokens[i].line);
-        }
-
-        break;
-      }
+    _parser_text_push(ast, max_s_chunks, node);
+    i += s_match;
+  }
+}
 
-      case lexer::TOKEN_INST_32IM_NOP:
-      case lexer::TOKEN_INST_32IM_OS_ECALL:
-      case lexer::TOKEN_INST_32IM_OS_EBREAK:
-      case lexer::TOKEN_INST_32IM_OS_SRET: 
-      case lexer::TOKEN_INST_32IM_FC_RET: {
-        _ast->text[_ast->s_text++] = (parser::RISCVASTN_Text){
-          .inst   = &(tokens[i]),
-          .f1     = nullptr,
-          .f2     = nullptr,
-          .f3     = nullptr,
-          .f4     = nullptr
-        };
-        incr = 1;
-        log(
-          "parser - parsed zero arg instruction rule ",
-          lexer::riscv_token_get_type_string(tokens[i].type),
-          tokens[i].filename,
-          tokens[i].line
-        );
-        break;
-      }
+uint64_t _parser_text_match(const lexer::RISCVTokenStream* tokens, const uint64_t i, parser::RISCVASTN_Text& node) {
+  const lexer::RISCVTokenType type = lexer::riscv_tokens_get_type(tokens, i);
+  if (type == lexer::TOKEN_SYMBOL) {
+    if (lexer::riscv_tokens_get_type(tokens, i + 1) != lexer::TOKEN_COLON)
+      return 0;
+    node = (parser::RISCVASTN_Text){ .inst = (uint32_t)i, .fields = 0, .form = 0 };
+    trace(TRACE_PARSER, "parser - parsed TOKEN_SYMBOL rule ", lexer::riscv_tokens_get_string(tokens, i), tokens->filename, lexer::riscv_tokens_get_line(tokens, i));
+    return 2;
+  }
+  if (!lexer::riscv_token_is_inst(type))
+    return 0;
+
+  // the first form the operands fit decides the node
+  const ParserInstRule* rule = &PARSER_INST_TABLE.rules[type];
+  uint16_t fields = 0;
+  for (uint8_t form = 0; form < rule->s_forms; form++) {
+    const uint64_t s_match = _parser_form_match(tokens, i, rule->forms[form], fields);
+    if (s_match > 0) {
+      node = (parser::RISCVASTN_Text){ .inst = (uint32_t)i, .fields = fields, .form = form };
+      trace(TRACE_PARSER, 
+        "parser - parsed instruction rule ",
+        lexer::riscv_token_get_type_string(type),
+        tokens->filename,
+        lexer::riscv_tokens_get_line(tokens, i)
+      );
+      return s_match;
+    }
+  }
+  return 0;
+}
 
-      case lexer::TOKEN_INST_32IM_FC_J:
-      case lexer::TOKEN_INST_32IM_FC_JR:
-      case lexer::TOKEN_INST_32IM_FC_CALL: {
-        _ast->error |= i + 1 >= s_tokens || lexer::riscv_token_is_inst(tokens[i + 1].type);
-        error(
-          FATAL,
-          _ast->error,
-          "parser - the following instruction requires a parameter: ",
-          lexer::riscv_token_get_type_string(tokens[i].type),
-          tokens[i].filename,
-          tokens[i].line
-        );
-
-        if (!_ast->error) {
-          _ast->text[_ast->s_text++] = (parser::RISCVASTN_Text){
-            .inst   = &(tokens[i]),
-            .f1     = &(tokens[i + 1]),
-            .f2     = nullptr,
-            .f3     = nullptr,
-            .f4     = nullptr
-          };
-          incr = 2;
-          log(
-            "parser - parsed one arg instruction rule ",
-            lexer::riscv_token_get_type_string(tokens[i].type),
-            tokens[i].filename,
-            tokens[i].line
-          );
-        }
+uint64_t _parser_text_report(parser::RISCVAST* ast, const lexer::RISCVTokenStream* tokens, const uint64_t i) {
+  const lexer::RISCVTokenType type = lexer::riscv_tokens_get_type(tokens, i);
+  error(
+    FATAL, 
+    type == lexer::TOKEN_SYMBOL,
+    "parser - following character is missing \":\": ",
+    lexer::riscv_tokens_get_string(tokens, i),
+    tokens->filename,
+    lexer::riscv_tokens_get_line(tokens, i)
+  );
+  error(
+    FATAL,
+    !lexer::riscv_token_is_inst(type),
+    "parser - invalid grammatical structure in .text: did not start with a supported instruction token ",
+    lexer::riscv_token_get_type_string(type),
+    tokens->filename,
+    lexer::riscv_tokens_get_line(tokens, i)
+  );
 
-        break;
-      }
+  // no form fits, the statement is reported and skipped so that the rest still gets checked
+  error(ERROR, true, PARSER_INST_TABLE.rules[type].msg, lexer::riscv_token_get_type_string(type), tokens->filename, lexer::riscv_tokens_get_line(tokens, i));
+  ast->error = true;
+  return _parser_skip_statement(tokens, i + 1);
+}
 
-      case lexer::TOKEN_INST_32IM_FC_JAL:
-      case lexer::TOKEN_INST_32IM_FC_JALR: {
-        _ast->error |= (
-          !(
-            i + 3 <= s_tokens &&
-            lexer::riscv_token_is_reg(tokens[i + 1].type) &&
-            tokens[i + 2].type == lexer::TOKEN_COMMA &&
-            tokens[i + 3].type == lexer::TOKEN_LIT_NUMBER
-          ) &&
-          !(
-            i + 1 < s_tokens &&
-            tokens[i + 1].type == lexer::TOKEN_SYMBOL
-          )
-        );
-        error(
-          FATAL,
-          _ast->error,
-          "parser - the following instruction requires either a register and an immediate or a symbol: ",
-          lexer::riscv_token_get_type_string(tokens[i].type),
-          tokens[i].filename,
-          tokens[i].line
-        );
-
-        if (!_ast->error) {
-          incr = tokens[i + 3].type == lexer::TOKEN_LIT_NUMBER ? 4 : 2;
-          _ast->text[_ast->s_text++] = (parser::RISCVASTN_Text){
-            .inst   = &(tokens[i]),
-            .f1     = &(tokens[i + 1]),
-            .f2     = incr == 4 ? &(tokens[i + 3]) : nullptr,
-            .f3     = nullptr,
-            .f4     = nullptr
-          };
-          log(
-            "parser - parsed one/two arg instruction rule ",
-            lexer::riscv_token_get_type_string(tokens[i].type),
-            tokens[i].filename,
-            tokens[i].line
-          );
-        }
+void _parser_text_push(parser::RISCVAST* ast, uint64_t& max_s_chunks, const parser::RISCVASTN_Text node) {
+  // only the chunk pointers are ever reallocated, nodes stay where they are
+  if ((ast->s_text & (AST_S_CHUNK - 1)) == 0) {
+    if (ast->s_chunks >= max_s_chunks) {
+      max_s_chunks <<= 1;
+      ast->text = (parser::RISCVASTN_Text**)realloc(ast->text, max_s_chunks * sizeof(parser::RISCVASTN_Text*));
+      error(FATAL, ast->text == nullptr, "parser - reallocation of text chunks returned a nullptr", "", __FILE__, __LINE__);
+    }
+    ast->text[ast->s_chunks] = (parser::RISCVASTN_Text*)malloc(AST_S_CHUNK * sizeof(parser::riscv_astn_text));
+    error(FATAL, ast->text[ast->s_chunks] == nullptr, "parser - allocation of text chunk returned a nullptr", "", __FILE__, __LINE__);
+    ast->s_chunks++;
+    trace(TRACE_PARSER, "parser - allocated text chunk", "", __FILE__, __LINE__);
+  }
 
-        break;
-      }
+  ast->text[ast->s_text >> AST_S_CHUNK_BITS][ast->s_text & (AST_S_CHUNK - 1)] = node;
+  ast->s_text++;
+}
 
-      case lexer::TOKEN_INST_32IM_MOVE_LI:
-      case lexer::TOKEN_INST_32IM_MOVE_LA:
-      case lexer::TOKEN_INST_32IM_MOVE_LUI:
-      case lexer::TOKEN_INST_32IM_MOVE_AUIPC:
-      case lexer::TOKEN_INST_32IM_MOVE_MV:
-      case lexer::TOKEN_INST_32IM_ALS_NEG:
-      case lexer::TOKEN_INST_32IM_ALS_NOT:
-      case lexer::TOKEN_INST_32IM_CP_SEQZ:
-      case lexer::TOKEN_INST_32IM_CP_SNEZ:
-      case lexer::TOKEN_INST_32IM_CP_SLTZ:
-      case lexer::TOKEN_INST_32IM_CP_SGTZ:
-      case lexer::TOKEN_INST_32IM_FC_BEQZ:
-      case lexer::TOKEN_INST_32IM_FC_BNEZ:
-      case lexer::TOKEN_INST_32IM_FC_BLEZ:
-      case lexer::TOKEN_INST_32IM_FC_BGEZ:
-      case lexer::TOKEN_INST_32IM_FC_BLTZ:
-      case lexer::TOKEN_INST_32IM_FC_BGTZ:
-      case lexer::TOKEN_INST_32IM_LNS_SQT: {
-        _ast->error |= (
-          i + 3 >= s_tokens ||
-          !lexer::riscv_token_is_param(tokens[i + 1].type) ||
-          tokens[i + 2].type != lexer::TOKEN_COMMA ||
-          !lexer::riscv_token_is_param(tokens[i + 3].type)
-        );
-        error(
-          FATAL,
-          _ast->error,
-          "parser - the following instruction requires two parameters separated by a comma: ",
-          lexer::riscv_token_get_type_string(tokens[i].type),
-          tokens[i].filename,
-          tokens[i].line
-        );
-
-        if (!_ast->error) {
-          _ast->text[_ast->s_text++] = (parser::RISCVASTN_Text){
-            .inst   = &(tokens[i]),
-            .f1     = &(tokens[i + 1]),
-            .f2     = &(tokens[i + 3]),
-            .f3     = nullptr,
-            .f4     = nullptr
-          };
-          incr = 4;
-          log(
-            "parser - parsed two arg instruction rule ",
-            lexer::riscv_token_get_type_string(tokens[i].type),
-            tokens[i].filename,
-            tokens[i].line
-          );
-        }
-        
-        break;
-      }
+void _parser_text_append(parser::RISCVAST* ast, uint64_t& max_s_chunks, const parser::RISCVASTN_Text* nodes, const uint64_t s_nodes) {
+  // the first node of every chunk goes through push, which allocates the
+  // chunk, the nodes that still fit in it are copied at once
+  for (uint64_t n = 0; n < s_nodes;) {
+    _parser_text_push(ast, max_s_chunks, nodes[n++]);
+    const uint64_t offset = ast->s_text & (AST_S_CHUNK - 1);
+    if (offset == 0)
+      continue;
+
+    const uint64_t s_copy = s_nodes - n < AST_S_CHUNK - offset ? s_nodes - n : AST_S_CHUNK - offset;
+    memcpy(&ast->text[ast->s_text >> AST_S_CHUNK_BITS][offset], nodes + n, s_copy * sizeof(parser::riscv_astn_text));
+    ast->s_text += s_copy;
+    n += s_copy;
+  }
+}
 
-      case lexer::TOKEN_INST_32IM_ALS_ADD:
-      case lexer::TOKEN_INST_32IM_ALS_ADDI:
-      case lexer::TOKEN_INST_32IM_ALS_SUB:
-      case lexer::TOKEN_INST_32IM_ALS_AND:
-      case lexer::TOKEN_INST_32IM_ALS_ANDI:
-      case lexer::TOKEN_INST_32IM_ALS_OR:
-      case lexer::TOKEN_INST_32IM_ALS_ORI:
-      case lexer::TOKEN_INST_32IM_ALS_XOR:
-      case lexer::TOKEN_INST_32IM_ALS_XORI:
-      case lexer::TOKEN_INST_32IM_ALS_SLL:
-      case lexer::TOKEN_INST_32IM_ALS_SLLI:
-      case lexer::TOKEN_INST_32IM_ALS_SRL:
-      case lexer::TOKEN_INST_32IM_ALS_SRLI:
-      case lexer::TOKEN_INST_32IM_ALS_SRA:
-      case lexer::TOKEN_INST_32IM_ALS_SRAI:
-      case lexer::TOKEN_INST_32IM_MD_MUL:
-      case lexer::TOKEN_INST_32IM_MD_MULH:
-      case lexer::TOKEN_INST_32IM_MD_MULSU:
-      case lexer::TOKEN_INST_32IM_MD_MULU:
-      case lexer::TOKEN_INST_32IM_MD_DIV:
-      case lexer::TOKEN_INST_32IM_MD_DIVU:
-      case lexer::TOKEN_INST_32IM_MD_REM:
-      case lexer::TOKEN_INST_32IM_MD_REMU:
-      case lexer::TOKEN_INST_32IM_CP_SLT:
-      case lexer::TOKEN_INST_32IM_CP_SLTI:
-      case lexer::TOKEN_INST_32IM_CP_SLTU:
-      case lexer::TOKEN_INST_32IM_CP_SLTIU:
-      case lexer::TOKEN_INST_32IM_FC_BEQ:
-      case lexer::TOKEN_INST_32IM_FC_BNE:
-      case lexer::TOKEN_INST_32IM_FC_BGT:
-      case lexer::TOKEN_INST_32IM_FC_BGE:
-      case lexer::TOKEN_INST_32IM_FC_BLE:
-      case lexer::TOKEN_INST_32IM_FC_BLT:
-      case lexer::TOKEN_INST_32IM_FC_BGTU:
-      case lexer::TOKEN_INST_32IM_FC_BGEU:
-      case lexer::TOKEN_INST_32IM_FC_BLTU:
-      case lexer::TOKEN_INST_32IM_FC_BLEU:
-      case lexer::TOKEN_INST_32IM_LNS_ADD:
-      case lexer::TOKEN_INST_32IM_LNS_SUB:
-      case lexer::TOKEN_INST_32IM_LNS_MUL:
-      case lexer::TOKEN_INST_32IM_LNS_DIV: {
-        _ast->error |= (
-          i + 5 >= s_tokens ||
-          !lexer::riscv_token_is_param(tokens[i + 1].type) ||
-          tokens[i + 2].type != lexer::TOKEN_COMMA ||
-          !lexer::riscv_token_is_param(tokens[i + 3].type) ||
-          tokens[i + 4].type != lexer::TOKEN_COMMA ||
-          !lexer::riscv_token_is_param(tokens[i + 5].type)
-        );
-        error(
-          FATAL,
-          _ast->error,
-          "parser - the following instruction requires three parameters separated by commas: ",
-          lexer::riscv_token_get_type_string(tokens[i].type),
-          tokens[i].filename,
-          tokens[i].line
-        );
-
-        if (!_ast->error) {
-          _ast->text[_ast->s_text++] = (parser::RISCVASTN_Text){
-            .inst   = &(tokens[i]),
-            .f1     = &(tokens[i + 1]),
-            .f2     = &(tokens[i + 3]),
-            .f3     = &(tokens[i + 5]),
-            .f4     = nullptr
-          };
-          incr = 6;
-          log(
-            "parser - parsed three arg instruction rule ",
-            lexer::riscv_token_get_type_string(tokens[i].type),
-            tokens[i].filename,
-            tokens[i].line
-          );
-        }
-        
-        break;
-      }      
-
-      case lexer::TOKEN_INST_32IM_LS_LB:
-      case lexer::TOKEN_INST_32IM_LS_LH:
-      case lexer::TOKEN_INST_32IM_LS_LW:
-      case lexer::TOKEN_INST_32IM_LS_LBU:
-      case lexer::TOKEN_INST_32IM_LS_LHU:
-      case lexer::TOKEN_INST_32IM_LS_SB:
-      case lexer::TOKEN_INST_32IM_LS_SH:
-      case lexer::TOKEN_INST_32IM_LS_SW: {
-        const bool symbol = (
-          i + 3 < s_tokens &&
-          lexer::riscv_token_is_param(tokens[i + 1].type) &&
-          tokens[i + 2].type == lexer::TOKEN_COMMA &&
-          tokens[i + 3].type == lexer::TOKEN_SYMBOL
-        );
-        const bool no_offset = (
-          i + 3 < s_tokens &&
-          lexer::riscv_token_is_param(tokens[i + 1].type) &&
-          tokens[i + 2].type == lexer::TOKEN_COMMA &&
-          (lexer::riscv_token_is_param(tokens[i + 3].type) && tokens[i + 3].type != lexer::TOKEN_LIT_NUMBER)
-        );
-        const bool offset = (
-          i + 6 < s_tokens &&
-          lexer::riscv_token_is_param(tokens[i + 1].type) &&
-          tokens[i + 2].type == lexer::TOKEN_COMMA &&
-          tokens[i + 3].type == lexer::TOKEN_LIT_NUMBER &&
-          tokens[i + 4].type == lexer::TOKEN_LPAREN &&
-          lexer::riscv_token_is_param(tokens[i + 5].type) &&
-          tokens[i + 6].type == lexer::TOKEN_RPAREN
-        );
-
-        _ast->error |= !symbol && !offset && !no_offset;
-        error(
-          FATAL,
-          _ast->error,
-          "parser - the following instruction requires two/three parameters as \"<inst> <xd>, <symbol> || <inst> <xd>, <imm>(<xa>)\": ",
-          lexer::riscv_token_get_type_string(tokens[i].type),
-          tokens[i].filename,
-          tokens[i].line
-        );
-
-        if (!_ast->error) {
-          if (offset) {
-            _ast->text[_ast->s_text++] = (parser::RISCVASTN_Text){
-              .inst   = &(tokens[i]),
-              .f1     = &(tokens[i + 1]),
-              .f2     = &(tokens[i + 3]),
-              .f3     = &(tokens[i + 5]),
-              .f4     = nullptr
-            };
-            incr = 7;
-          } else {
-            _ast->text[_ast->s_text++] = (parser::RISCVASTN_Text){
-              .inst   = &(tokens[i]),
-              .f1     = &(tokens[i + 1]),
-              .f2     = &(tokens[i + 3]),
-              .f3     = nullptr,
-              .f4     = nullptr
-            };
-            incr = 4;
-          }
-          log(
-            "parser - parsed load/store instruction rule ",
-            lexer::riscv_token_get_type_string(tokens[i].type),
-            tokens[i].filename,
-            tokens[i].line
-          );
-        }
-        
-        break;
-      }
+uint8_t _parser_operand_class(const lexer::RISCVTokenType type) {
+  if (lexer::riscv_token_is_reg(type))
+    return OPERAND_REG;
+  if (type == lexer::TOKEN_LIT_NUMBER)
+    return OPERAND_IMM;
+  if (type == lexer::TOKEN_SYMBOL)
+    return OPERAND_SYM;
+  return 0;
+}
 
-      default: {
-        error(
-          FATAL,
-          true,
-          "parser - invalid grammatical structure in .text: did not start with a supported instruction token ",
-          lexer::riscv_token_get_type_string(tokens[i].type),
-          tokens[i].filename,
-          tokens[i].line
-        );
-        break;
-      }
+uint64_t _parser_form_match(
+  const lexer::RISCVTokenStream* tokens, const uint64_t i,
+  const ParserForm& form, uint16_t& fields
+) {
+  // operands are comma separated, a memory form writes its last one in parentheses
+  uint64_t j = i + 1;
+  fields = 0;
+  for (uint32_t k = 0; k < form.s_operands; k++) {
+    if (k > 0) {
+      const lexer::RISCVTokenType separator = form.mem && k + 1 == form.s_operands ? lexer::TOKEN_LPAREN : lexer::TOKEN_COMMA;
+      if (lexer::riscv_tokens_get_type(tokens, j++) != separator)
+        return 0;
     }
+    if (!(_parser_operand_class(lexer::riscv_tokens_get_type(tokens, j)) & form.operands[k]))
+      return 0;
+    fields |= (uint16_t)((j - i) << (k * AST_FIELD_BITS));
+    j++;
   }
+  if (form.mem && lexer::riscv_tokens_get_type(tokens, j++) != lexer::TOKEN_RPAREN)
+    return 0;
+
+  // a statement ends where the next one starts, anything else is a stray operand
+  const lexer::RISCVTokenType next = lexer::riscv_tokens_get_type(tokens, j);
+  const bool end =
+    next == lexer::TOKEN_NONE || next == lexer::TOKEN_DATA || next == lexer::TOKEN_TEXT ||
+    lexer::riscv_token_is_inst(next) ||
+    (next == lexer::TOKEN_SYMBOL && lexer::riscv_tokens_get_type(tokens, j + 1) == lexer::TOKEN_COLON);
+  if (!end)
+    return 0;
+  return j - i;
+}
 
-  *ast = _ast;
+uint64_t _parser_skip_statement(const lexer::RISCVTokenStream* tokens, uint64_t i) {
+  for (;; i++) {
+    const lexer::RISCVTokenType type = lexer::riscv_tokens_get_type(tokens, i);
+    if (
+      i >= tokens->s_tokens || type == lexer::TOKEN_DATA || lexer::riscv_token_is_inst(type) ||
+      (type == lexer::TOKEN_SYMBOL && lexer::riscv_tokens_get_type(tokens, i + 1) == lexer::TOKEN_COLON)
+    )
+      return i;
+  }
 }
 
 void _parser_parse_data(
   parser::RISCVAST* ast, uint64_t& max_s_data,
-  lexer::RISCVToken* tokens, const uint64_t s_tokens, uint64_t& i
+  const lexer::RISCVTokenStream* tokens, uint64_t& i, const uint64_t end
 ) {
-  if (tokens[i++].type != lexer::TOKEN_DATA)
-    return;
-
-  ast->data = (parser::RISCVASTN_Data*)malloc(max_s_data * sizeof(parser::riscv_astn_data));
-  error(FATAL, ast->data == nullptr, "parser - allocation of RISCVASTN_Data* returned a nullptr", "", __FILE__, __LINE__);
-  
-  while (i < s_tokens && tokens[i].type != lexer::TOKEN_TEXT) {
+  // stops on the .text that ends the section, or at end
+  while (i < end && lexer::riscv_tokens_get_type(tokens, i) != lexer::TOKEN_TEXT) {
     if (ast->s_data >= max_s_data) {
       max_s_data <<= 1;
       ast->data = (parser::RISCVASTN_Data*)realloc(ast->data, max_s_data * sizeof(parser::riscv_astn_data));
@@ -811,10 +350,10 @@ void _parser_parse_data(
     }
 
     const char
-      *symbol      = tokens[i].lit.string,
-      *filename    = tokens[i].filename;
-    uint32_t line = tokens[i].line;
-    log(
+      *symbol      = lexer::riscv_tokens_get_string(tokens, i),
+      *filename    = tokens->filename;
+    uint32_t line = lexer::riscv_tokens_get_line(tokens, i);
+    trace(TRACE_PARSER, 
       "parser - parsing symbol ",
       symbol,
       filename,
@@ -824,69 +363,150 @@ void _parser_parse_data(
     error(
       FATAL,
       !(
-        i + 3 < s_tokens && 
-        tokens[i].type == lexer::TOKEN_SYMBOL &&
-        tokens[i + 1].type == lexer::TOKEN_COLON &&
-        lexer::riscv_token_is_data_type(tokens[i + 2].type) &&
-        lexer::riscv_token_is_lit(tokens[i + 3].type)
+        i + 3 < end && 
+        lexer::riscv_tokens_get_type(tokens, i) == lexer::TOKEN_SYMBOL &&
+        lexer::riscv_tokens_get_type(tokens, i + 1) == lexer::TOKEN_COLON &&
+        lexer::riscv_token_is_data_type(lexer::riscv_tokens_get_type(tokens, i + 2)) &&
+        lexer::riscv_token_is_lit(lexer::riscv_tokens_get_type(tokens, i + 3))
       ),
       "parser - invalid grammatical structure in .data: did not follow the convention \"<symbol>: .<type> <data>\"",
       "",
-      tokens[i].filename,
-      tokens[i].line
+      tokens->filename,
+      lexer::riscv_tokens_get_line(tokens, i)
     );
 
-    uint64_t max_s_arr = 1 << 2;
-    uint64_t j = ast->s_data;
+    const uint64_t j = ast->s_data;
     ast->data[ast->s_data++] = (parser::RISCVASTN_Data){
-      .s_arr      = 0,
-      .symbol     = &(tokens[i]),
-      .type       = &(tokens[i + 2]),
-      .arr        = (lexer::RISCVToken**)malloc(max_s_arr * sizeof(lexer::RISCVToken*))
+      .symbol     = (uint32_t)i,
+      .type       = (uint32_t)(i + 2),
+      .s_lits     = 0
     };
     i += 3;
 
-    while (i < s_tokens && lexer::riscv_token_is_lit(tokens[i].type)) {
-      if (ast->data[j].s_arr >= max_s_arr) {
-        max_s_arr <<= 1;
-        ast->data[j].arr = (lexer::RISCVToken**)realloc(
-          ast->data[j].arr,
-          max_s_arr * sizeof(lexer::RISCVToken*)
-        );
-        error(
-          FATAL,
-          ast->data[j].arr == nullptr,
-          "parser - reallocation of RISCVASTN_Data* returned a nullptr",
-          "",
-          __FILE__,
-          __LINE__
-        );
-      }
+    while (i < end && lexer::riscv_token_is_lit(lexer::riscv_tokens_get_type(tokens, i))) {
+      ast->data[j].s_lits++;
+      _parser_check_width(ast, tokens, ast->data[j].type, i);
 
-      ast->data[j].arr[ast->data[j].s_arr++] = &(tokens[i]);
+      // a missing comma would break the literal stride, the rest of the
+      // directive is reported and dropped
+      const bool error = lexer::riscv_token_is_lit(lexer::riscv_tokens_get_type(tokens, i + 1));
+      ast->error |= error;
       error(
         ERROR,
-        lexer::riscv_token_is_lit(tokens[i + 1].type),
+        error,
         "parser - invalid grammatical structre in .data: two consecutive literals not separated by a comma",
         "",
-        tokens[i].filename,
-        tokens[i].line
+        tokens->filename,
+        lexer::riscv_tokens_get_line(tokens, i)
       );
-      i += 1 + (tokens[i + 1].type == lexer::TOKEN_COMMA);
-    }
-
-    if (ast->data[j].s_arr != max_s_arr) {
-      ast->data[j].arr = (lexer::RISCVToken**)realloc(ast->data[j].arr, ast->data[j].s_arr * sizeof(lexer::RISCVToken*));
-      error(FATAL, ast->data->arr == nullptr, "parser - final reallocation of RISCVASTN_Data* returned a nullptr", "", __FILE__, __LINE__);
+      if (error) {
+        for (i++; lexer::riscv_token_is_lit(lexer::riscv_tokens_get_type(tokens, i)) || lexer::riscv_tokens_get_type(tokens, i) == lexer::TOKEN_COMMA; i++);
+        break;
+      }
+      i += 1 + (lexer::riscv_tokens_get_type(tokens, i + 1) == lexer::TOKEN_COMMA);
     }
 
-    log(
+    trace(TRACE_PARSER, 
       "parser - parsed symbol ",
       symbol,
       filename,
       line
     );
   }
+}
+
+void _parser_check_width(parser::RISCVAST* ast, const lexer::RISCVTokenStream* tokens, const uint64_t type_i, const uint64_t i) {
+  // the lexer only knows literals are 32 bit, narrower directives are checked here
+  const lexer::RISCVTokenType type = lexer::riscv_tokens_get_type(tokens, type_i);
+  if ((type != lexer::TOKEN_BYTE && type != lexer::TOKEN_HALF) || lexer::riscv_tokens_get_type(tokens, i) != lexer::TOKEN_LIT_NUMBER)
+    return;
+
+  const int64_t
+    bits   = (int64_t)lexer::riscv_token_get_type_size(type) << 3,
+    min    = -((int64_t)1 << (bits - 1)),
+    max    = ((int64_t)1 << bits) - 1,
+    number = lexer::riscv_tokens_get_number(tokens, i);
+  const bool error = number < min || number > max;
+  ast->error |= error;
+  error(
+    ERROR,
+    error,
+    CHECK_ERROR_MSG_WIDTH,
+    lexer::riscv_token_get_type_string(type),
+    tokens->filename,
+    lexer::riscv_tokens_get_line(tokens, i)
+  );
+}
+
+void _parser_symbols_note(parser::RISCVAST* ast, const lexer::RISCVTokenStream* tokens, const uint64_t s_text, const uint64_t s_data) {
+  // nodes from s_text and s_data on are new, tokens is the stream they index
+  // while it still has its lines
+  if (tokens->strtab->s_entries > ast->max_s_symbols) {
+    uint32_t max_s_symbols = ast->max_s_symbols > 0 ? ast->max_s_symbols : 1 << 6;
+    for (; max_s_symbols < tokens->strtab->s_entries; max_s_symbols <<= 1);
+
+    const uint64_t s_words = ast->max_s_symbols >> 6, max_s_words = max_s_symbols >> 6;
+    ast->defined    = (uint64_t*)realloc(ast->defined, max_s_words * sizeof(uint64_t));
+    ast->referenced = (uint64_t*)realloc(ast->referenced, max_s_words * sizeof(uint64_t));
+    error(FATAL, ast->defined == nullptr || ast->referenced == nullptr, "parser - reallocation of symbol bits returned a nullptr", "", __FILE__, __LINE__);
+    memset(ast->defined + s_words, 0, (max_s_words - s_words) * sizeof(uint64_t));
+    memset(ast->referenced + s_words, 0, (max_s_words - s_words) * sizeof(uint64_t));
+    ast->max_s_symbols = max_s_symbols;
+  }
+  if (tokens->strtab->s_entries > ast->s_symbols)
+    ast->s_symbols = tokens->strtab->s_entries;
+
+  // definitions first, a reference to a symbol defined in the same range is not kept
+  for (uint64_t d = s_data; d < ast->s_data; d++) {
+    const uint32_t id = lexer::riscv_tokens_get_id(tokens, ast->data[d].symbol);
+    ast->defined[id >> 6] |= 1ull << (id & 63);
+  }
+  for (uint64_t t = s_text; t < ast->s_text; t++) {
+    const parser::RISCVASTN_Text* node = parser::ast_get_text(ast, t);
+    if (lexer::riscv_tokens_get_type(tokens, node->inst) == lexer::TOKEN_SYMBOL) {
+      const uint32_t id = lexer::riscv_tokens_get_id(tokens, node->inst);
+      ast->defined[id >> 6] |= 1ull << (id & 63);
+    }
+  }
+
+  for (uint64_t t = s_text; t < ast->s_text; t++) {
+    const parser::RISCVASTN_Text* node = parser::ast_get_text(ast, t);
+    for (uint32_t k = 1; k <= AST_S_FIELDS; k++) {
+      const uint32_t field = parser::ast_get_field(node, k);
+      if (field == AST_TOKEN_NONE)
+        break;
+      if (lexer::riscv_tokens_get_type(tokens, field) != lexer::TOKEN_SYMBOL)
+        continue;
 
-  error(FATAL, ast->data == nullptr, "parser - ast->data is a nullptr at the end of the .data function", "", __FILE__, __LINE__);
+      const uint32_t id = lexer::riscv_tokens_get_id(tokens, field);
+      const uint64_t bit = 1ull << (id & 63);
+      if ((ast->defined[id >> 6] | ast->referenced[id >> 6]) & bit)
+        continue;
+      ast->referenced[id >> 6] |= bit;
+
+      if (ast->s_refs >= ast->max_s_refs) {
+        ast->max_s_refs = ast->max_s_refs > 0 ? ast->max_s_refs << 1 : 1 << 4;
+        ast->refs = (parser::RISCVAST_Ref*)realloc(ast->refs, ast->max_s_refs * sizeof(parser::riscv_ast_ref));
+        error(FATAL, ast->refs == nullptr, "parser - reallocation of symbol references returned a nullptr", "", __FILE__, __LINE__);
+      }
+      ast->refs[ast->s_refs++] = (parser::RISCVAST_Ref){ .symbol = id, .line = lexer::riscv_tokens_get_line(tokens, field) };
+    }
+  }
+}
+
+void _parser_symbols_check(parser::RISCVAST* ast) {
+  // refs are in the order they were first made, so this goes in file order
+  for (uint64_t r = 0; r < ast->s_refs; r++) {
+    const uint32_t id = ast->refs[r].symbol;
+    const bool error = !(ast->defined[id >> 6] & (1ull << (id & 63)));
+    ast->error |= error;
+    error(
+      ERROR,
+      error,
+      "parser - undefined symbol: ",
+      lexer::riscv_strtab_get(ast->tokens->strtab, id),
+      ast->tokens->filename,
+      ast->refs[r].line
+    );
+  }
 }
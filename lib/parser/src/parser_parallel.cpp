@@ -0,0 +1,126 @@
+#include <thread>
+#include <vector>
+
+#include "parser_private.hpp"
+
+namespace parser {
+  RISCVAST* parse_parallel(const lexer::RISCVTokenStream* tokens, const uint32_t s_threads) {
+    error(FATAL, tokens == nullptr || tokens->s_tokens == 0, "parser - tokens is a nullptr", "", __FILE__, __LINE__);
+    error(FATAL, s_threads == 0, "parser - parallel parsing needs at least one thread", "", __FILE__, __LINE__);
+
+    // only .text is split, .data nodes are few and cheap next to it
+    ParserState state = PARSER_STATE_INIT;
+    state.s_threads = s_threads;
+    RISCVAST* ast = _parser_ast_create(tokens, state.max_s_chunks);
+    ast->error = tokens->error;
+
+    uint64_t i = 0;
+    _parser_parse_range(ast, state, tokens, i, tokens->s_tokens);
+    _parser_symbols_note(ast, tokens, 0, 0);
+    _parser_symbols_check(ast);
+
+    trace(TRACE_PARSER, "parser - returning ast", "", __FILE__, __LINE__);
+    return ast;
+  }
+}
+
+void _parser_parse_text_parallel(
+  parser::RISCVAST* ast, ParserState& state,
+  const lexer::RISCVTokenStream* tokens, uint64_t& i, const uint64_t end
+) {
+  // the section runs up to the next .data, types are one byte each
+  const uint8_t* data = (const uint8_t*)memchr(tokens->types + i, lexer::TOKEN_DATA, (size_t)(end - i));
+  const uint64_t end_text = data != nullptr ? (uint64_t)(data - tokens->types) : end;
+
+  ParserPart* parts = (ParserPart*)malloc(state.s_threads * sizeof(ParserPart));
+  error(FATAL, parts == nullptr, "parser - allocation of text parts returned a nullptr", "", __FILE__, __LINE__);
+  const uint32_t s_parts = _parser_parts_split(parts, state.s_threads, tokens, i, end_text);
+  trace(TRACE_PARSER, "parser - split .text into parts: ", s_parts, __FILE__, __LINE__);
+
+  if (s_parts <= 1) {
+    free(parts);
+    _parser_parse_text(ast, state.max_s_chunks, tokens, i, end);
+    return;
+  }
+
+  std::vector<std::thread> threads;
+  for (uint32_t p = 0; p < s_parts; p++)
+    threads.emplace_back(_parser_part_parse, &parts[p], tokens);
+  for (std::thread& thread : threads)
+    thread.join();
+
+  // a part whose thread stopped early is finished on this thread, after the
+  // parts before it, which reports its errors in file order; a fatal one
+  // exits before anything past it is looked at, as it would in parse
+  for (uint32_t p = 0; p < s_parts; p++) {
+    _parser_text_append(ast, state.max_s_chunks, parts[p].nodes, parts[p].s_nodes);
+    if (parts[p].stop < parts[p].end) {
+      uint64_t j = parts[p].stop;
+      _parser_parse_text(ast, state.max_s_chunks, tokens, j, parts[p].end);
+    }
+    free(parts[p].nodes);
+  }
+  free(parts);
+
+  i = end_text;
+}
+
+uint32_t _parser_parts_split(
+  ParserPart* parts, const uint32_t max_s_parts,
+  const lexer::RISCVTokenStream* tokens, const uint64_t begin_text, const uint64_t end_text
+) {
+  uint64_t s_parts = (end_text - begin_text) / PARSER_MIN_S_PART;
+  s_parts = s_parts < 1 ? 1 : (s_parts > max_s_parts ? max_s_parts : s_parts);
+
+  uint64_t begin = begin_text;
+  uint32_t n = 0;
+  for (uint64_t c = 1; c <= s_parts && begin < end_text; c++) {
+    uint64_t end = c == s_parts ? end_text : begin_text + (end_text - begin_text) * c / s_parts;
+    if (end <= begin)
+      continue; // the previous part ran over this one looking for a label
+
+    // parse lands on every label, whatever came before it, so parts that
+    // start on one give the same nodes as a single pass
+    for (; end < end_text; end++) {
+      if (
+        lexer::riscv_tokens_get_type(tokens, end) == lexer::TOKEN_SYMBOL &&
+        lexer::riscv_tokens_get_type(tokens, end + 1) == lexer::TOKEN_COLON
+      )
+        break;
+    }
+
+    parts[n++] = (ParserPart){
+      .begin       = begin,
+      .end         = end,
+      .stop        = begin,
+      .nodes       = nullptr,
+      .s_nodes     = 0,
+      .max_s_nodes = 0
+    };
+    begin = end;
+  }
+  return n;
+}
+
+void _parser_part_parse(ParserPart* part, const lexer::RISCVTokenStream* tokens) {
+  // most statements take four tokens or more, so this seldom grows
+  part->max_s_nodes = (part->end - part->begin) / 4 + 1;
+  part->nodes = (parser::RISCVASTN_Text*)malloc(part->max_s_nodes * sizeof(parser::riscv_astn_text));
+  error(FATAL, part->nodes == nullptr, "parser - allocation of part nodes returned a nullptr", "", __FILE__, __LINE__);
+
+  uint64_t i = part->begin;
+  while (i < part->end) {
+    if (part->s_nodes >= part->max_s_nodes) {
+      part->max_s_nodes <<= 1;
+      part->nodes = (parser::RISCVASTN_Text*)realloc(part->nodes, part->max_s_nodes * sizeof(parser::riscv_astn_text));
+      error(FATAL, part->nodes == nullptr, "parser - reallocation of part nodes returned a nullptr", "", __FILE__, __LINE__);
+    }
+
+    const uint64_t s_match = _parser_text_match(tokens, i, part->nodes[part->s_nodes]);
+    if (s_match == 0)
+      break;
+    part->s_nodes++;
+    i += s_match;
+  }
+  part->stop = i;
+}
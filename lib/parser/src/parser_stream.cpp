@@ -0,0 +1,189 @@
+#include <thread>
+
+#include "parser_private.hpp"
+
+/*
+ * parse_stream overlaps lexing and parsing: a thread runs the streaming lexer
+ * and hands its batches over through a small ring, the calling thread parses
+ * them as they come. Statements may run across batches, so a batch is only
+ * parsed up to the last statement that starts in it and the rest waits for
+ * the next one. Once a range is parsed, the tokens its nodes refer to are
+ * copied to the caller's stream and the range is dropped, so neither the
+ * token array nor the source is ever resident as a whole.
+ */
+
+namespace parser {
+  RISCVAST* parse_stream(const char* filename, lexer::RISCVTokenStream* tokens) {
+    error(FATAL, tokens == nullptr, "parser - tokens is a nullptr", "", __FILE__, __LINE__);
+
+    // the lexer thread interns into the string table of tokens and is the only
+    // one to touch it until it is done, the parser reads strings through a
+    // table that borrows the entries each batch brings along
+    lexer::RISCVStrTab* strtab = lexer::riscv_strtab_create();
+    lexer::riscv_strtab_borrow(strtab, tokens->strtab->entries, tokens->strtab->s_entries);
+
+    ParserQueue queue;
+    queue.head      = 0;
+    queue.s_batches = 0;
+    queue.ended     = false;
+    for (uint32_t b = 0; b < PARSER_S_QUEUE; b++) {
+      queue.batches[b] = (ParserBatch){
+        .tokens        = lexer::riscv_tokens_create(filename, tokens->strtab),
+        .strings       = nullptr,
+        .s_strings     = 0,
+        .max_s_strings = 1 << 6
+      };
+      queue.batches[b].strings = (struct lexer::riscv_strtab::riscv_strtab_entry*)malloc(
+        queue.batches[b].max_s_strings * sizeof(struct lexer::riscv_strtab::riscv_strtab_entry)
+      );
+      error(FATAL, queue.batches[b].strings == nullptr, "parser - allocation of batch strings returned a nullptr", "", __FILE__, __LINE__);
+    }
+
+    lexer::RISCVTokenStream* window = lexer::riscv_tokens_create(filename, strtab);
+    uint64_t s_tokens = 0;
+
+    ParserState state = PARSER_STATE_INIT;
+    RISCVAST* ast = _parser_ast_create(tokens, state.max_s_chunks);
+    trace(TRACE_PARSER, "parser - streaming ", filename, __FILE__, __LINE__);
+
+    std::thread lexer(_parser_stream_lex, &queue, filename, tokens->strtab);
+    for (;;) {
+      std::unique_lock<std::mutex> lock(queue.mutex);
+      queue.cond.wait(lock, [&queue]() { return queue.s_batches > 0 || queue.ended; });
+      if (queue.s_batches == 0)
+        break;
+      const ParserBatch* batch = &queue.batches[queue.head];
+      lock.unlock();
+
+      lexer::riscv_strtab_borrow(strtab, batch->strings, batch->s_strings);
+      lexer::riscv_tokens_append(window, batch->tokens);
+      s_tokens += batch->tokens->s_tokens;
+
+      lock.lock();
+      queue.head = (queue.head + 1) % PARSER_S_QUEUE;
+      queue.s_batches--;
+      lock.unlock();
+      queue.cond.notify_all();
+
+      _parser_stream_parse(ast, state, window, _parser_stream_boundary(window), tokens);
+    }
+    lexer.join();
+
+    error(FATAL, s_tokens == 0, "parser - tokens is a nullptr", "", __FILE__, __LINE__);
+    _parser_stream_parse(ast, state, window, window->s_tokens, tokens);
+    ast->error |= window->error;
+    _parser_symbols_check(ast);
+
+    for (uint32_t b = 0; b < PARSER_S_QUEUE; b++) {
+      lexer::riscv_tokens_free(queue.batches[b].tokens);
+      free(queue.batches[b].strings);
+    }
+    lexer::riscv_tokens_free(window);
+    lexer::riscv_strtab_free(strtab);
+
+    trace(TRACE_PARSER, "parser - retained tokens: ", tokens->s_tokens, __FILE__, __LINE__);
+    return ast;
+  }
+}
+
+void _parser_stream_lex(ParserQueue* queue, const char* filename, lexer::RISCVStrTab* strtab) {
+  lexer::RISCVLexer* lexer = lexer::riscv_lexer_open(filename, strtab);
+  lexer::RISCVTokenStream* tokens = lexer::riscv_tokens_create(filename, strtab);
+
+  uint32_t s_strings = strtab->s_entries;
+  for (;;) {
+    const bool more = lexer::riscv_lexer_next_batch(lexer, tokens, PARSER_S_BATCH);
+
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    queue->cond.wait(lock, [queue]() { return queue->s_batches < PARSER_S_QUEUE; });
+    ParserBatch* batch = &queue->batches[(queue->head + queue->s_batches) % PARSER_S_QUEUE];
+    lock.unlock();
+
+    // the slot is past the ones the parser may look at until it is pushed
+    if (more) {
+      lexer::riscv_tokens_drop(batch->tokens, batch->tokens->s_tokens);
+      lexer::riscv_tokens_append(batch->tokens, tokens);
+
+      batch->s_strings = strtab->s_entries - s_strings;
+      if (batch->s_strings > batch->max_s_strings) {
+        batch->max_s_strings = batch->s_strings << 1;
+        batch->strings = (struct lexer::riscv_strtab::riscv_strtab_entry*)realloc(
+          batch->strings,
+          batch->max_s_strings * sizeof(struct lexer::riscv_strtab::riscv_strtab_entry)
+        );
+        error(FATAL, batch->strings == nullptr, "parser - reallocation of batch strings returned a nullptr", "", __FILE__, __LINE__);
+      }
+      memcpy(batch->strings, strtab->entries + s_strings, batch->s_strings * sizeof(struct lexer::riscv_strtab::riscv_strtab_entry));
+      s_strings = strtab->s_entries;
+    }
+
+    lock.lock();
+    queue->s_batches += more;
+    queue->ended      = !more;
+    lock.unlock();
+    queue->cond.notify_all();
+
+    if (!more)
+      break;
+    trace(TRACE_PARSER, "parser - pushed batch of tokens: ", tokens->s_tokens, __FILE__, __LINE__);
+  }
+
+  lexer::riscv_tokens_free(tokens);
+  lexer::riscv_lexer_close(lexer);
+}
+
+uint64_t _parser_stream_boundary(const lexer::RISCVTokenStream* tokens) {
+  // the last token a statement starts on, whatever comes before it is whole;
+  // a symbol only starts one if its colon is there already
+  for (uint64_t i = tokens->s_tokens; i-- > 0;) {
+    const lexer::RISCVTokenType type = lexer::riscv_tokens_get_type(tokens, i);
+    if (
+      type == lexer::TOKEN_DATA || lexer::riscv_token_is_inst(type) ||
+      (type == lexer::TOKEN_SYMBOL && lexer::riscv_tokens_get_type(tokens, i + 1) == lexer::TOKEN_COLON)
+    )
+      return i;
+  }
+  return 0;
+}
+
+void _parser_stream_parse(
+  parser::RISCVAST* ast, ParserState& state,
+  lexer::RISCVTokenStream* window, const uint64_t end, lexer::RISCVTokenStream* tokens
+) {
+  const uint64_t s_text = ast->s_text, s_data = ast->s_data;
+  uint64_t i = 0;
+  _parser_parse_range(ast, state, window, i, end);
+  _parser_symbols_note(ast, window, s_text, s_data);
+
+  // nodes are moved over to the tokens they keep, an instruction keeps its
+  // operands and loses the separators between them
+  for (uint64_t t = s_text; t < ast->s_text; t++) {
+    parser::RISCVASTN_Text* node = &ast->text[t >> AST_S_CHUNK_BITS][t & (AST_S_CHUNK - 1)];
+    const uint32_t inst = (uint32_t)lexer::riscv_tokens_retain(tokens, window, node->inst);
+
+    uint16_t fields = 0;
+    for (uint32_t k = 1; k <= AST_S_FIELDS; k++) {
+      const uint32_t field = parser::ast_get_field(node, k);
+      if (field == AST_TOKEN_NONE)
+        break;
+      lexer::riscv_tokens_retain(tokens, window, field);
+      fields |= (uint16_t)(k << ((k - 1) * AST_FIELD_BITS));
+    }
+    node->inst   = inst;
+    node->fields = fields;
+  }
+
+  // literals keep the commas between them since they are read with a stride
+  for (uint64_t d = s_data; d < ast->s_data; d++) {
+    parser::RISCVASTN_Data* node = &ast->data[d];
+    const uint32_t
+      symbol = (uint32_t)lexer::riscv_tokens_retain(tokens, window, node->symbol),
+      type   = (uint32_t)lexer::riscv_tokens_retain(tokens, window, node->type);
+    for (uint64_t j = node->type + 1; j <= parser::ast_get_lit(node, node->s_lits - 1); j++)
+      lexer::riscv_tokens_retain(tokens, window, j);
+    node->symbol = symbol;
+    node->type   = type;
+  }
+
+  lexer::riscv_tokens_drop(window, end);
+}
@@ -3,17 +3,39 @@
 
 #include <cstdlib>
 #include <cstdint>
+#include <cstring>
 
 #include "lexer.hpp"
 #include "parser.hpp"
 #include "mapper.hpp"
 
 void print_help() {
-  std::cout << "riscv <your_file.s>";
+  std::cout << "riscv [-j <threads>] [-T <layout_file> | -L <layout>] <your_file.s> | riscv -d <your_file.bin>";
 }
 
 int32_t main(int argc, char* argv[]) {
-  if (argc != 2) {
+  if (argc == 3 && strcmp(argv[1], "-d") == 0) {
+    mapper::map_disassemble(argv[2]);
+    return 0;
+  }
+
+  // every option takes a value, the source file comes last
+  uint32_t s_threads = 1;
+  const char* layout_filename = nullptr;
+  const char* layout_text = nullptr;
+  bool valid = true;
+  for (; argc > 2 && argv[1][0] == '-'; argc -= 2, argv += 2) {
+    if (strcmp(argv[1], "-j") == 0)
+      s_threads = (uint32_t)strtoul(argv[2], nullptr, 10);
+    else if (strcmp(argv[1], "-T") == 0)
+      layout_filename = argv[2];
+    else if (strcmp(argv[1], "-L") == 0)
+      layout_text = argv[2];
+    else
+      valid = false;
+  }
+
+  if (!valid || argc != 2 || s_threads == 0) {
     std::cerr << "[ERROR]: main - invalid arguments" << std::endl;
     print_help();
     exit(1);
@@ -21,49 +43,78 @@ int32_t main(int argc, char* argv[]) {
 
   const char* filename = argv[1];
 
-  uint64_t s_tokens = 0;
-  lexer::RISCVToken* tokens = lexer::lex(filename, s_tokens);
+  // the layout is checked before the source is even opened
+  mapper::RISCVLayout layout;
+  const bool layout_ok =
+    layout_filename != nullptr ? mapper::map_layout_load(layout_filename, layout) :
+    layout_text != nullptr     ? mapper::map_layout_parse(layout_text, "-L", layout) :
+                                 mapper::map_layout_parse(MAPPER_LAYOUT_DEFAULT, "default layout", layout);
+  if (!layout_ok)
+    exit(1);
 
-  parser::RISCVAST* ast = parser::parse(tokens, s_tokens);
-  parser::check(ast);
+  // with a single thread lexing and parsing overlap and tokens only holds
+  // what the tree refers to, more threads lex the whole file in parallel
+  // first and then parse .text in parallel
+  lexer::RISCVStrTab* strtab = lexer::riscv_strtab_create();
+  lexer::RISCVTokenStream* tokens = nullptr;
+  parser::RISCVAST* ast = nullptr;
+  if (s_threads > 1) {
+    tokens = lexer::lex_parallel(filename, strtab, s_threads);
+    ast    = parser::parse_parallel(tokens, s_threads);
+  } else {
+    tokens = lexer::riscv_tokens_create(filename, strtab);
+    ast    = parser::parse_stream(filename, tokens);
+  }
 
-  const int32_t error = (int32_t)ast->error;
+  int32_t error = (int32_t)ast->error;
   if (!error) {
     mapper::RISCVEncoding encoding = {
       .s_insts    = 0,
       .s_data     = 0,
-      .s_stack    = 1 << 10, // in words (4 bytes each)
-      .text_addr  = 0x80000000,
-      .data_addr  = 0x80001000,
-      .stack_addr = 0x80002000,
+      .s_stack    = 0,
+      .text_addr  = 0,
+      .data_addr  = 0,
+      .stack_addr = 0,
       .insts      = nullptr,
-      .data       = nullptr
+      .data       = nullptr,
+      .file       = nullptr,
+      .s_file     = 0
     };
 
-    encoding.data  = mapper::map_data2bin(ast, encoding.s_data);
-    encoding.insts = mapper::map_inst2bin(
-      ast, encoding.s_insts,
-      encoding.text_addr, encoding.data_addr,
-      encoding.stack_addr, encoding.s_stack
-    );
-    error(
-      FATAL,
-      encoding.insts == nullptr,
-      "main - mapper returned a nullptr array of instructions",
-      "",
-      __FILE__,
-      __LINE__
-    );
-
-    mapper::write(filename, encoding);
-
-    free(encoding.insts);
-    if (encoding.data != nullptr)
-      free(encoding.data);
+    // the layout gives both sections their exact size, so the output file is
+    // mapped once and encoded into in place
+    parser::RISCVIR* ir = parser::lower(ast);
+    uint8_t* sizes = (uint8_t*)malloc(ir->s_insts > 0 ? ir->s_insts : 1);
+    error(FATAL, sizes == nullptr, "main - allocation of instruction sizes returned a nullptr", "", __FILE__, __LINE__);
+    encoding.s_insts = mapper::map_text_size(ir, sizes);
+    encoding.s_data  = mapper::map_data_size(ast);
+
+    // sections are placed before anything is written, a program that does
+    // not fit its regions leaves no output behind
+    error = !mapper::map_layout(layout, encoding);
+    if (!error) {
+      mapper::map_output(filename, encoding);
+
+      // data is read straight out of the source, text only needs the lowered
+      // program, so tokens and tree are gone before instructions are encoded
+      mapper::map_data2bin(ast, encoding.data);
+      parser::ast_free(ast);
+      lexer::riscv_tokens_free(tokens);
+      lexer::riscv_strtab_free(strtab);
+      ast    = nullptr;
+      tokens = nullptr;
+      strtab = nullptr;
+
+      mapper::map_inst2bin(ir, sizes, encoding.insts, encoding.text_addr, encoding.data_addr, s_threads);
+      mapper::unmap_output(encoding);
+    }
+    parser::ir_free(ir);
+    free(sizes);
   }
 
   parser::ast_free(ast);
-  lexer::riscv_tokens_free(tokens, s_tokens);
+  lexer::riscv_tokens_free(tokens);
+  lexer::riscv_strtab_free(strtab);
 
   return error;
 }
@@ -0,0 +1,1328 @@
+# Test branch relaxation: an unrolled LNS dot product whose loop spans more
+# than the 4 KiB a conditional branch reaches, so the loop branch and the
+# early exit are assembled as an inverted branch over a jal
+
+.data
+    weights: .half 0x0100, 0x0198, 0x00C0, 0xFF00   # 2.0, 3.0, 1.5, 0.5
+    acc: .half 0
+
+.text
+main:
+    li s0, 4                # rounds
+    la s1, weights
+    lhu t1, 0(s1)
+    li t2, 0
+
+loop:
+    beqz s0, done           # forward, past the unrolled body
+    # lane 0
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 1
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 2
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 4
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 5
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 6
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 7
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 8
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 9
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 10
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 11
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 12
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 13
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 14
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 15
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 16
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 17
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 18
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 19
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 20
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 21
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 22
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 23
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 24
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 25
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 26
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 27
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 28
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 29
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 30
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 31
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 32
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 33
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 34
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 35
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 36
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 37
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 38
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 39
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 40
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 41
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 42
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 43
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 44
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 45
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 46
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 47
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 48
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 49
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 50
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 51
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 52
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 53
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 54
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 55
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 56
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 57
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 58
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 59
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 60
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 61
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 62
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 63
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 64
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 65
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 66
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 67
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 68
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 69
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 70
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 71
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 72
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 73
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 74
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 75
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 76
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 77
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 78
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 79
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 80
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 81
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 82
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 83
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 84
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 85
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 86
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 87
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 88
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 89
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 90
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 91
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 92
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 93
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 94
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 95
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 96
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 97
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 98
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 99
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 100
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 101
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 102
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 103
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 104
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 105
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 106
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 107
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 108
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 109
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 110
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 111
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 112
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 113
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 114
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 115
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 116
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 117
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 118
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 119
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 120
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 121
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 122
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 123
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 124
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 125
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 126
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 127
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 128
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 129
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 130
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 131
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 132
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 133
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 134
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 135
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 136
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 137
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 138
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 139
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 140
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 141
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 142
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 143
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 144
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 145
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 146
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 147
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 148
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 149
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 150
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 151
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 152
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 153
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 154
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 155
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 156
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 157
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 158
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 159
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 160
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 161
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 162
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 163
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 164
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 165
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 166
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 167
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 168
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 169
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 170
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 171
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 172
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 173
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 174
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 175
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 176
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 177
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 178
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 179
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 180
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 181
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 182
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 183
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 184
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 185
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 186
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 187
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 188
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 189
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 190
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 191
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 192
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 193
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 194
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 195
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 196
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 197
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 198
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 199
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 200
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 201
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 202
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 203
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 204
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 205
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 206
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 207
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 208
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 209
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 210
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 211
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 212
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 213
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 214
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 215
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 216
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 217
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 218
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 219
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 220
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 221
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 222
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 223
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 224
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 225
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 226
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 227
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 228
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 229
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 230
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 231
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 232
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 233
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 234
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 235
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 236
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 237
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 238
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 239
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 240
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 241
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 242
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 243
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 244
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 245
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 246
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 247
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 248
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 249
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 250
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 251
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 252
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 253
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 254
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 255
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 256
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 257
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 258
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    # lane 259
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+    lmul t3, t1, t1
+    ladd t2, t2, t3
+
+    addi s0, s0, -1
+    bnez s0, loop           # backward, over the unrolled body
+
+done:
+    la s1, acc
+    sh t2, 0(s1)
+
+    # Exit
+    li a7, 10
+    ecall